@@ -0,0 +1,51 @@
+#include <format>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "../includes/mbs/backend/async_eval.h"
+#include "../includes/mbs/frontend/parser.h"
+
+// 100 rules each reading one remote record, against a resolver with 200 us of
+// latency per call: evaluated together, their lookups share one call, evaluated
+// one by one they make a call each
+void bench::asyncEval() {
+    constexpr int RULES = 100;
+
+    Interpreter::Bindings records;
+    std::vector<mbs::Parser> rules(RULES);
+    for (int i = 0; i < RULES; ++i) {
+        records.emplace(std::format("balance_{}", i), i * 10);
+        rules[i].parse(std::format("balance_{} > limit", i));
+    }
+    InMemoryResolver resolver(records, std::chrono::microseconds(200));
+    const Interpreter::Bindings local = {{"limit", 500}};
+
+    const auto base = run("one by one", [&] {
+        for (auto &rule: rules) {
+            AsyncEvaluator evaluator(resolver, local);
+            evaluator.submit(rule.root());
+            keep(evaluator.run());
+        }
+    });
+    run("batched", [&] {
+        AsyncEvaluator evaluator(resolver, local);
+        for (auto &rule: rules) evaluator.submit(rule.root());
+        keep(evaluator.run());
+    }, base);
+
+    // Without latency, the cost of suspending and resuming the coroutines
+    InMemoryResolver instant(records);
+    Interpreter::Bindings all = records;
+    all.merge(Interpreter::Bindings(local));
+    Interpreter interp(all);
+
+    const auto sync = run("synchronous, every record in memory", [&] {
+        for (auto &rule: rules) keep(interp.evaluate(rule.root()));
+    });
+    run("batched, resolver without latency", [&] {
+        AsyncEvaluator evaluator(instant, local);
+        for (auto &rule: rules) evaluator.submit(rule.root());
+        keep(evaluator.run());
+    }, sync);
+}
@@ -0,0 +1,107 @@
+#ifndef MBSCRIPT_BENCH_H
+#define MBSCRIPT_BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <string_view>
+#include <utility>
+
+// Minimal timing harness for `mbs_bench`. Results are only meaningful relative to
+// each other, on the same machine and build, so every suite times its feature next
+// to the baseline it replaces.
+namespace bench {
+    using Clock = std::chrono::steady_clock;
+
+    // A batch of calls is grown until it runs for this long, then timed a few times
+    constexpr auto ROUND_TIME = std::chrono::milliseconds(50);
+    constexpr int ROUNDS = 5;
+
+    // Hides `value` from the optimizer so that the work producing it isn't elided
+    template<typename T>
+    void keep(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r"(&value) : "memory");
+#else
+        static const volatile void *sink;
+        sink = &value;
+#endif
+    }
+
+    // Calls of `fn` in a batch running for at least `ROUND_TIME`
+    template<typename Fn>
+    std::size_t calibrate(Fn &fn) {
+        std::size_t batch = 1;
+        while (true) {
+            const auto start = Clock::now();
+            for (std::size_t i = 0; i < batch; ++i) fn();
+            if (Clock::now() - start >= ROUND_TIME) return batch;
+            batch *= 2;
+        }
+    }
+
+    template<typename Fn>
+    double time(Fn &fn, const std::size_t batch) {
+        const auto start = Clock::now();
+        for (std::size_t i = 0; i < batch; ++i) fn();
+        const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        return elapsed.count() / static_cast<double>(batch);
+    }
+
+    // Nanoseconds per call of `fn`, the best of `ROUNDS` timed batches
+    template<typename Fn>
+    double measure(Fn &&fn) {
+        const auto batch = calibrate(fn);
+        double best = std::numeric_limits<double>::infinity();
+        for (int round = 0; round < ROUNDS; ++round) best = std::min(best, time(fn, batch));
+        return best;
+    }
+
+    // `measure` for two functions with their rounds interleaved, so that both run
+    // under the same machine conditions, for differences of a few percent
+    template<typename A, typename B>
+    std::pair<double, double> measure(A &&a, B &&b) {
+        const auto batchA = calibrate(a);
+        const auto batchB = calibrate(b);
+        std::pair best{std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
+        for (int round = 0; round < 2 * ROUNDS; ++round) {
+            best.first = std::min(best.first, time(a, batchA));
+            best.second = std::min(best.second, time(b, batchB));
+        }
+        return best;
+    }
+
+    void heading(std::string_view title);
+    // One result line, with the speedup over `baseline` nanoseconds when there is one
+    void print(std::string_view name, double nanos, double baseline = 0);
+    void note(std::string_view text);
+
+    // Measures `fn` and prints its time per call, returning it
+    template<typename Fn>
+    double run(const std::string_view name, Fn &&fn, const double baseline = 0) {
+        const auto nanos = measure(fn);
+        print(name, nanos, baseline);
+        return nanos;
+    }
+
+    // Suites, one per feature, see `main.cpp`
+    void ruleIndex();
+    void specializer();
+    void typeChecker();
+    void memberAccess();
+    void strings();
+    void builtins();
+    void patterns();
+    void numbers();
+    void profiler();
+    void budgets();
+    void asyncEval();
+    void incremental();
+    void reactive();
+    void parallelParse();
+    void bindings();
+    void serializer();
+}
+
+#endif //MBSCRIPT_BENCH_H
@@ -0,0 +1,40 @@
+#include "bench.h"
+#include "../includes/mbs/mbs.h"
+
+namespace {
+    struct Order {
+        int64_t qty;
+        double price;
+        StringValue sku;
+        bool rush;
+    };
+}
+
+template<>
+struct mbs::Fields<Order> {
+    static constexpr auto list = std::tuple{
+        field("qty", &Order::qty),
+        field("price", &Order::price),
+        field("sku", &Order::sku),
+        field("rush", &Order::rush),
+    };
+};
+
+// One program bound to a host struct and to a string-keyed map, each evaluated
+// returning a value and into an `EvalScratch`
+void bench::bindings() {
+    const auto source = "qty * price > 100 && sku.startsWith('AB') || rush";
+    auto typed = mbs::TypedProgram<Order>::compile(source);
+    auto program = mbs::Program::compile(source);
+
+    const Order order{.qty = 12, .price = 9.5, .sku = StringValue(std::string("ABC-1")), .rush = false};
+    const mbs::Program::Bindings map = {
+        {"qty", order.qty}, {"price", order.price}, {"sku", RuntimeValue(order.sku)}, {"rush", order.rush},
+    };
+    EvalScratch scratch;
+
+    const auto base = run("map bindings", [&] { keep(program.evaluate(map)); });
+    run("map bindings, into scratch", [&] { keep(program.evaluate(map, scratch)); }, base);
+    run("typed host object", [&] { keep(typed.evaluate(order)); }, base);
+    run("typed host object, into scratch", [&] { keep(typed.evaluate(order, scratch)); }, base);
+}
@@ -0,0 +1,47 @@
+#include <algorithm>
+#include <array>
+#include <format>
+
+#include "bench.h"
+#include "../includes/mbs/backend/interpreter.h"
+#include "../includes/mbs/frontend/parser.h"
+
+// The same evaluation unbudgeted, and with step, memory and deadline limits that
+// are never reached, so the difference is the cost of checking them
+void bench::budgets() {
+    const Interpreter::Bindings bindings = {{"qty", 12}, {"price", 9.5}, {"sku", "ABC-123"}, {"tier", 3}};
+    Interpreter interp(bindings);
+
+    mbs::Parser parser;
+    parser.parse("qty * price > 100 && startsWith(sku, 'AB') && (tier ** 2 + qty) % 7 < 5 && lower(sku) != 'x'");
+
+    const EvalBudget steps{.maxSteps = 1'000'000, .maxMemory = 0, .deadline = std::nullopt};
+    const EvalBudget all{
+        .maxSteps = 1'000'000,
+        .maxMemory = 1 << 20,
+        .deadline = Clock::now() + std::chrono::hours(24),
+    };
+
+    const auto eval = [&] { keep(interp.evaluate(parser.root())); };
+    const auto [base, stepped] = measure(eval, [&] { keep(interp.evaluate(parser.root(), steps)); });
+    const auto [baseAgain, full] = measure(eval, [&] { keep(interp.evaluate(parser.root(), all)); });
+
+    print("no budget", base);
+    print("step limit", stepped, base);
+    print("step, memory and deadline limits", full, baseAgain);
+
+    // A few percent is within run to run noise, so report the spread of repeated
+    // measurements rather than a single one
+    const auto overheads = [&](const EvalBudget &budget) {
+        std::array<double, 5> runs{};
+        for (auto &run: runs) {
+            const auto [unbudgeted, budgeted] = measure(eval, [&] { keep(interp.evaluate(parser.root(), budget)); });
+            run = 100 * (budgeted / unbudgeted - 1);
+        }
+        std::ranges::sort(runs);
+        return std::format("median {:.1f}%, from {:.1f}% to {:.1f}% over {} runs",
+                           runs[runs.size() / 2], runs.front(), runs.back(), runs.size());
+    };
+    note("overhead with a step limit: " + overheads(steps));
+    note("overhead with every limit: " + overheads(all));
+}
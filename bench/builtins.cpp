@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <cctype>
+#include <format>
+#include <random>
+#include <string>
+
+#include "bench.h"
+#include "../includes/mbs/backend/interpreter.h"
+#include "../includes/mbs/backend/string_kernels.h"
+#include "../includes/mbs/frontend/parser.h"
+
+namespace {
+    // Lowercase text with the needle the string builtins look for at the very end
+    std::string text(const std::size_t size) {
+        std::mt19937 rng(5);
+        std::string str;
+        while (str.size() + 15 < size) str += "etaoin shrdlu"[rng() % 13];
+        return str + "needle@corp.com";
+    }
+}
+
+// Each builtin called through the interpreter, on a short and a 4 KiB string for
+// the string builtins; then the kernels behind them against the standard library
+void bench::builtins() {
+    const auto shortText = text(32);
+    const auto longText = text(4096);
+
+    for (const auto *str: {&shortText, &longText}) {
+        const Interpreter::Bindings bindings = {{"s", *str}, {"n", -42}, {"x", 12.75}};
+        Interpreter interp(bindings);
+
+        for (const auto *call: {"len(s)", "lower(s)", "upper(s)", "contains(s, 'e@corp')",
+                                "startsWith(s, 'etaoin')", "endsWith(s, '.com')"}) {
+            mbs::Parser parser;
+            parser.parse(call);
+            run(std::format("{}, {} bytes", call, str->size()), [&] { keep(interp.evaluate(parser.root())); });
+        }
+    }
+
+    const Interpreter::Bindings numbers = {{"n", -42}, {"x", 12.75}};
+    Interpreter interp(numbers);
+    for (const auto *call: {"abs(n)", "floor(x)", "ceil(x)", "n.abs()"}) {
+        mbs::Parser parser;
+        parser.parse(call);
+        run(call, [&] { keep(interp.evaluate(parser.root())); });
+    }
+
+    std::string out(longText.size(), '\0');
+    const auto find = run("std::string_view::find, 4 KiB", [&] {
+        keep(std::string_view(longText).find("e@corp"));
+    });
+    run("kernels::find, 4 KiB", [&] { keep(kernels::find(longText, "e@corp")); }, find);
+
+    const auto lower = run("std::tolower loop, 4 KiB", [&] {
+        std::transform(longText.begin(), longText.end(), out.begin(), [](const char c) {
+            return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        });
+        keep(out);
+    });
+    run("kernels::toLower, 4 KiB", [&] {
+        kernels::toLower(longText.data(), out.data(), longText.size());
+        keep(out);
+    }, lower);
+}
@@ -0,0 +1,34 @@
+#include <format>
+#include <string>
+
+#include "bench.h"
+#include "../includes/mbs/frontend/incremental.h"
+#include "../includes/mbs/frontend/parser.h"
+
+// Typing and deleting one digit in the middle of a 1 MB document of rules, against
+// parsing the whole document again
+void bench::incremental() {
+    std::string document;
+    for (int i = 0; document.size() < 1024 * 1024; ++i) {
+        document += std::format("amount_{} > {} && status == 'open' || owner.role == 'admin'\n", i, i * 7);
+    }
+
+    mbs::IncrementalParser parser(document);
+    const auto offset = document.find("> ", document.size() / 2) + 2;
+    note(std::format("{} bytes, {} top-level expressions", document.size(), parser.root().nodes().size()));
+
+    const auto full = run("full parse", [&] {
+        mbs::Parser fresh;
+        fresh.parse(document);
+        keep(fresh.root());
+    });
+
+    bool inserted = false;
+    run("IncrementalParser::edit", [&] {
+        if (inserted) parser.edit(offset, 1, "");
+        else parser.edit(offset, 0, "1");
+        inserted = !inserted;
+        keep(parser.root());
+    }, full);
+    note(std::format("{} top-level expression(s) re-parsed by the last edit", parser.reparsed()));
+}
@@ -0,0 +1,82 @@
+// `mbs_bench [suite...]` runs the named suites, or all of them, `--list` lists them
+
+#include <algorithm>
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "bench.h"
+
+namespace {
+    struct Suite {
+        std::string_view name;
+        std::string_view description;
+        void (*run)();
+    };
+
+    constexpr Suite SUITES[] = {
+        {"rule_index", "matching a record against growing rule sets", bench::ruleIndex},
+        {"specializer", "residual programs against the full program", bench::specializer},
+        {"type_checker", "specialized operators against runtime dispatch", bench::typeChecker},
+        {"member", "member paths through inline caches against by-name lookups", bench::memberAccess},
+        {"strings", "interned against uninterned string comparison", bench::strings},
+        {"builtins", "every builtin, and the string kernels against the standard library", bench::builtins},
+        {"pattern", "`~=` on the DFA, the NFA fallback and dynamic patterns", bench::patterns},
+        {"numbers", "integer against double arithmetic", bench::numbers},
+        {"profiler", "evaluation with and without an active profiler", bench::profiler},
+        {"budget", "evaluation with and without a budget", bench::budgets},
+        {"async", "batched against one-by-one remote lookups", bench::asyncEval},
+        {"incremental", "single char edits in a 1 MB document against full parses", bench::incremental},
+        {"reactive", "single binding updates over 10k expressions", bench::reactive},
+        {"parallel_parse", "parse time against thread count", bench::parallelParse},
+        {"bindings", "typed host objects against map bindings", bench::bindings},
+        {"serializer", "AST and token dumps of a 1M node tree", bench::serializer},
+    };
+}
+
+int main(const int argc, char **argv) {
+    if (argc > 1 && std::string_view(argv[1]) == "--list") {
+        for (const auto &suite: SUITES) std::cout << std::format("{:<16} {}\n", suite.name, suite.description);
+        return 0;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view name = argv[i];
+        if (std::ranges::none_of(SUITES, [&](const Suite &suite) { return suite.name == name; })) {
+            std::cerr << "Unknown suite `" << name << "`, see --list" << std::endl;
+            return 1;
+        }
+    }
+
+    for (const auto &suite: SUITES) {
+        const auto selected = argc == 1 || std::any_of(argv + 1, argv + argc, [&](const char *arg) {
+            return suite.name == arg;
+        });
+        if (!selected) continue;
+
+        bench::heading(std::format("{}: {}", suite.name, suite.description));
+        suite.run();
+    }
+    return 0;
+}
+
+void bench::heading(const std::string_view title) {
+    std::cout << '\n' << title << '\n';
+}
+
+void bench::print(const std::string_view name, const double nanos, const double baseline) {
+    std::string time;
+    if (nanos < 1e3) time = std::format("{:.1f} ns", nanos);
+    else if (nanos < 1e6) time = std::format("{:.2f} us", nanos / 1e3);
+    else if (nanos < 1e9) time = std::format("{:.2f} ms", nanos / 1e6);
+    else time = std::format("{:.2f} s", nanos / 1e9);
+
+    std::cout << std::format("  {:<52} {:>12}", name, time);
+    if (baseline > 0) std::cout << std::format("   x{:.2f}", baseline / nanos);
+    std::cout << '\n';
+}
+
+void bench::note(const std::string_view text) {
+    std::cout << "  " << text << '\n';
+}
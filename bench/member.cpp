@@ -0,0 +1,78 @@
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "../includes/mbs/backend/interpreter.h"
+#include "../includes/mbs/backend/type_checker.h"
+#include "../includes/mbs/frontend/parser.h"
+
+namespace {
+    // `auth.user.role.level` over objects with a few fields per level, the ones on
+    // the path last. Every call builds new shapes, so two records built by it have
+    // the same layout and field names but never share a shape id.
+    RuntimeValue makeAuth(std::shared_ptr<const Shape> &shape) {
+        const auto role = std::make_shared<const Shape>(std::vector<Shape::Field>{
+            {"name", ValueType::STRING, nullptr}, {"scope", ValueType::STRING, nullptr},
+            {"since", ValueType::NUMBER, nullptr}, {"level", ValueType::NUMBER, nullptr},
+        });
+        const auto user = std::make_shared<const Shape>(std::vector<Shape::Field>{
+            {"id", ValueType::STRING, nullptr}, {"email", ValueType::STRING, nullptr},
+            {"active", ValueType::BOOL, nullptr}, {"role", ValueType::OBJECT, role},
+        });
+        shape = std::make_shared<const Shape>(std::vector<Shape::Field>{
+            {"token", ValueType::STRING, nullptr}, {"issuer", ValueType::STRING, nullptr},
+            {"expires", ValueType::NUMBER, nullptr}, {"user", ValueType::OBJECT, user},
+        });
+        return RuntimeValue::object(shape, {
+            "t0k3n", "idp", 1700000000,
+            RuntimeValue::object(user, {
+                "u1", "u1@corp.com", true, RuntimeValue::object(role, {"admin", "orders", 2019, 3}),
+            }),
+        });
+    }
+}
+
+// The same member path over the same objects, once with every step missing its
+// inline cache and resolving the field by name, once hitting it
+void bench::memberAccess() {
+    std::shared_ptr<const Shape> shapeA, shapeB;
+    const Interpreter::Bindings bindingsA = {{"auth", makeAuth(shapeA)}};
+    const Interpreter::Bindings bindingsB = {{"auth", makeAuth(shapeB)}};
+    Interpreter interpA(bindingsA);
+    Interpreter interpB(bindingsB);
+
+    // One node alternating between both records, so each step sees a new shape
+    mbs::Parser shared;
+    shared.parse("auth.user.role.level");
+    auto &sharedNode = *shared.root().nodes()[0];
+
+    // One node per record, each staying primed for its own shapes
+    mbs::Parser forA, forB;
+    forA.parse("auth.user.role.level");
+    forB.parse("auth.user.role.level");
+    auto &nodeA = *forA.root().nodes()[0];
+    auto &nodeB = *forB.root().nodes()[0];
+
+    // Primed by the type checker rather than the first evaluation
+    mbs::Parser resolvedA, resolvedB;
+    resolvedA.parse("auth.user.role.level");
+    resolvedB.parse("auth.user.role.level");
+    TypeChecker({}, {{"auth", shapeA}}).check(resolvedA.root());
+    TypeChecker({}, {{"auth", shapeB}}).check(resolvedB.root());
+    auto &resolvedNodeA = *resolvedA.root().nodes()[0];
+    auto &resolvedNodeB = *resolvedB.root().nodes()[0];
+
+    note("two evaluations per call, one per record");
+    const auto base = run("cache misses, fields looked up by name", [&] {
+        keep(interpA.evaluate(sharedNode));
+        keep(interpB.evaluate(sharedNode));
+    });
+    run("inline cache hits", [&] {
+        keep(interpA.evaluate(nodeA));
+        keep(interpB.evaluate(nodeB));
+    }, base);
+    run("primed at compile time", [&] {
+        keep(interpA.evaluate(resolvedNodeA));
+        keep(interpB.evaluate(resolvedNodeB));
+    }, base);
+}
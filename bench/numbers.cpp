@@ -0,0 +1,18 @@
+#include "bench.h"
+#include "../includes/mbs/backend/interpreter.h"
+#include "../includes/mbs/frontend/parser.h"
+
+// An integer-heavy predicate with its inputs bound as integers, and as doubles
+// holding the same values
+void bench::numbers() {
+    mbs::Parser parser;
+    parser.parse("(a * 31 + b) % 97 == c && a - b > c * 2 && (a + b + c) % 2 == 0");
+
+    const Interpreter::Bindings ints = {{"a", int64_t{123456}}, {"b", int64_t{789}}, {"c", int64_t{40}}};
+    const Interpreter::Bindings doubles = {{"a", 123456.0}, {"b", 789.0}, {"c", 40.0}};
+    Interpreter intInterp(ints);
+    Interpreter doubleInterp(doubles);
+
+    const auto base = run("doubles", [&] { keep(doubleInterp.evaluate(parser.root())); });
+    run("int64", [&] { keep(intInterp.evaluate(parser.root())); }, base);
+}
@@ -0,0 +1,34 @@
+#include <algorithm>
+#include <format>
+#include <string>
+#include <thread>
+
+#include "bench.h"
+#include "../includes/mbs/frontend/parallel_parser.h"
+#include "../includes/mbs/frontend/parser.h"
+
+// A bulk import of 50k rules, parsed serially and then on 1 thread up to one per core
+void bench::parallelParse() {
+    std::string script;
+    for (int i = 0; i < 50000; ++i) {
+        script += std::format("tenant == {} && (amount > {} || lower(region) == 'eu') && tags ~= '.*vip.*'\n",
+                              i, i % 1000);
+    }
+    const auto cores = std::max(std::thread::hardware_concurrency(), 1u);
+    note(std::format("{} MB, {} core(s)", script.size() / (1024 * 1024), cores));
+
+    const auto serial = run("Parser", [&] {
+        mbs::Parser parser;
+        parser.parse(script);
+        keep(parser.root());
+    });
+
+    for (unsigned threads = 1;; threads = std::min(threads * 2, cores)) {
+        run(std::format("ParallelParser, {} thread(s)", threads), [&] {
+            mbs::ParallelParser parser(threads);
+            parser.parse(script);
+            keep(parser.root());
+        }, serial);
+        if (threads == cores) break;
+    }
+}
@@ -0,0 +1,38 @@
+#include <regex>
+#include <string>
+
+#include "bench.h"
+#include "../includes/mbs/backend/interpreter.h"
+#include "../includes/mbs/backend/pattern.h"
+#include "../includes/mbs/frontend/parser.h"
+
+// `~=` on order references, compiled as a literal prefix, a DFA, and an NFA for a
+// pattern whose DFA would blow up; then with the pattern bound at run time, which
+// goes through the compiled pattern cache
+void bench::patterns() {
+    const Interpreter::Bindings bindings = {
+        {"ref", "ORD-2024-000123456-EU-WEST-PRIORITY"},
+        {"bits", "abbabababbbabaabababbbabaababbabbbaababab"},
+        {"pattern", "ORD-[0-9]+-[0-9]+(-[A-Z]+)*"},
+    };
+    Interpreter interp(bindings);
+
+    const auto time = [&](const char *name, const char *source, const double baseline = 0) {
+        mbs::Parser parser;
+        parser.parse(source);
+        return run(name, [&] { keep(interp.evaluate(parser.root())); }, baseline);
+    };
+
+    time("prefix, `ref ~= 'ORD-.*'`", "ref ~= 'ORD-.*'");
+    const auto dfa = time("DFA, `ref ~= 'ORD-[0-9]+-[0-9]+(-[A-Z]+)*'`", "ref ~= 'ORD-[0-9]+-[0-9]+(-[A-Z]+)*'");
+    time("NFA, `bits ~= '(a|b)*a(a|b)(a|b)...'`",
+         "bits ~= '(a|b)*a(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)'");
+    time("dynamic, `ref ~= pattern`", "ref ~= pattern", dfa);
+
+    const std::regex regex("ORD-[0-9]+-[0-9]+(-[A-Z]+)*");
+    const std::string ref = "ORD-2024-000123456-EU-WEST-PRIORITY";
+    const auto library = run("std::regex_match, same pattern as the DFA", [&] { keep(std::regex_match(ref, regex)); });
+    print("DFA against std::regex_match", dfa, library);
+
+    run("Pattern::compile, DFA", [&] { keep(Pattern::compile("ORD-[0-9]+-[0-9]+(-[A-Z]+)*")); });
+}
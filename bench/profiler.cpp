@@ -0,0 +1,30 @@
+#include "bench.h"
+#include "../includes/mbs/backend/interpreter.h"
+#include "../includes/mbs/backend/profiler.h"
+#include "../includes/mbs/frontend/parser.h"
+
+// Evaluation without and with an active profiler. Without `MBS_PROFILE` the hooks
+// are compiled out, so the first line compared across both builds is their cost
+// when no profiler is active.
+void bench::profiler() {
+    const Interpreter::Bindings bindings = {{"qty", 12}, {"price", 9.5}, {"sku", "ABC-123"}, {"rush", false}};
+    Interpreter interp(bindings);
+
+    mbs::Parser parser;
+    parser.parse("qty * price > 100 && startsWith(sku, 'AB') || rush && len(sku) > 3");
+
+    const auto eval = [&] { keep(interp.evaluate(parser.root())); };
+    if constexpr (!Profiler::enabled) {
+        run("no active profiler", eval);
+        note("Profiling hooks compiled out, rebuild with -DMBS_PROFILE=ON to time an active profiler");
+        return;
+    }
+
+    Profiler profiler;
+    const auto [base, active] = measure(eval, [&] {
+        const Profiler::Session session(profiler);
+        eval();
+    });
+    print("no active profiler", base);
+    print("active profiler", active, base);
+}
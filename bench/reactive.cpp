@@ -0,0 +1,51 @@
+#include <format>
+#include <string>
+
+#include "bench.h"
+#include "../includes/mbs/backend/interpreter.h"
+#include "../includes/mbs/backend/reactive.h"
+#include "../includes/mbs/frontend/parser.h"
+
+// 10k expressions over 100 variables; after each single variable update every value
+// is read again, so about 2% of the expressions have to be recomputed
+void bench::reactive() {
+    constexpr int EXPRESSIONS = 10000;
+    constexpr int VARIABLES = 100;
+
+    std::string script;
+    for (int i = 0; i < EXPRESSIONS; ++i) {
+        script += std::format("x{} * 2 + y{} > {} && x{} != x{}\n", i % VARIABLES, (i + 1) % VARIABLES, i % 50,
+                              i % VARIABLES, (i + 7) % VARIABLES);
+    }
+    mbs::Parser parser;
+    parser.parse(script);
+
+    Interpreter::Bindings bindings;
+    for (int i = 0; i < VARIABLES; ++i) {
+        bindings.emplace(std::format("x{}", i), i);
+        bindings.emplace(std::format("y{}", i), i);
+    }
+
+    ReactiveEvaluator evaluator(bindings);
+    for (const auto &expr: parser.root().nodes()) evaluator.add(*expr);
+    for (std::size_t id = 0; id < EXPRESSIONS; ++id) keep(evaluator.value(id));
+
+    int update = 0;
+    const auto full = run("re-evaluating every expression", [&] {
+        ++update;
+        bindings[std::format("x{}", update % VARIABLES)] = update;
+        Interpreter interp(bindings);
+        for (const auto &expr: parser.root().nodes()) keep(interp.evaluate(*expr));
+    });
+
+    run("ReactiveEvaluator", [&] {
+        ++update;
+        evaluator.set(std::format("x{}", update % VARIABLES), update);
+        for (std::size_t id = 0; id < EXPRESSIONS; ++id) keep(evaluator.value(id));
+    }, full);
+
+    evaluator.resetCounters();
+    evaluator.set("x0", -1);
+    for (std::size_t id = 0; id < EXPRESSIONS; ++id) keep(evaluator.value(id));
+    note(std::format("one update: {} nodes recomputed, {} reused", evaluator.recomputed(), evaluator.reused()));
+}
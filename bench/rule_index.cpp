@@ -0,0 +1,42 @@
+#include <format>
+#include <random>
+#include <string>
+
+#include "bench.h"
+#include "../includes/mbs/backend/interpreter.h"
+#include "../includes/mbs/backend/rule_index.h"
+#include "../includes/mbs/frontend/parser.h"
+
+// Rules each guarded by one tenant, matched against records of a single tenant, so
+// the index only evaluates a handful of candidates however many rules there are
+void bench::ruleIndex() {
+    for (const int rules: {1000, 10000, 100000}) {
+        const int tenants = rules / 4;
+        std::mt19937 rng(1);
+        RuleIndex index;
+        std::string script;
+        for (int i = 0; i < rules; ++i) {
+            const auto source = std::format("tenant == {} && amount > {}", i % tenants, rng() % 1000);
+            index.addRule(source);
+            script += source + '\n';
+        }
+
+        mbs::Parser parser;
+        parser.parse(script);
+
+        int tenant = 0;
+        const auto record = [&] {
+            tenant = (tenant + 1) % tenants;
+            return Interpreter::Bindings{{"tenant", tenant}, {"amount", 500}};
+        };
+
+        const auto scan = run(std::format("{} rules, evaluating every rule", rules), [&] {
+            const auto bindings = record();
+            Interpreter interp(bindings);
+            std::size_t matched = 0;
+            for (const auto &rule: parser.root().nodes()) matched += interp.evaluate(*rule).isTruthy();
+            keep(matched);
+        });
+        run(std::format("{} rules, RuleIndex::match", rules), [&] { keep(index.match(record())); }, scan);
+    }
+}
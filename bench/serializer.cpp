@@ -0,0 +1,54 @@
+#include <format>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+#include "bench.h"
+#include "../includes/mbs/frontend/lexer.h"
+#include "../includes/mbs/frontend/parser.h"
+#include "../includes/mbs/frontend/serializer.h"
+
+namespace {
+    // Discards its output, only counting it, so that the serializer is timed alone
+    class CountingBuffer : public std::streambuf {
+    public:
+        std::size_t bytes = 0;
+
+    protected:
+        int_type overflow(const int_type ch) override {
+            ++bytes;
+            return traits_type::not_eof(ch);
+        }
+
+        std::streamsize xsputn(const char *, const std::streamsize count) override {
+            bytes += static_cast<std::size_t>(count);
+            return count;
+        }
+    };
+}
+
+// Dumps of a script parsed into 2^20 nodes, 16 per line, and of its tokens
+void bench::serializer() {
+    std::string script;
+    for (int i = 0; i < 65536; ++i) {
+        script += std::format("a{} * (b + {}) > c && -d < {} || name == 'x{}'\n", i % 10, i, i % 100, i);
+    }
+    mbs::Parser parser;
+    parser.parse(script);
+    mbs::Lexer lexer;
+    lexer.lex(script);
+
+    CountingBuffer buffer;
+    std::ostream out(&buffer);
+
+    for (const auto format: {AstSerializer::Format::DEBUG, AstSerializer::Format::JSON}) {
+        const auto *name = format == AstSerializer::Format::DEBUG ? "debug" : "JSON";
+        run(std::format("AST, {}", name), [&] { AstSerializer(out, format).write(parser.root()); });
+        run(std::format("tokens, {}", name), [&] { AstSerializer(out, format).write(lexer.tokens); });
+    }
+
+    buffer.bytes = 0;
+    AstSerializer(out, AstSerializer::Format::JSON).write(parser.root());
+    note(std::format("{} top-level expressions, {} MB of JSON", parser.root().nodes().size(),
+                     buffer.bytes / (1024 * 1024)));
+}
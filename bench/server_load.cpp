@@ -0,0 +1,221 @@
+// Load generator for `mbs --serve`: keeps a window of EVALUATE requests in flight
+// and reports the throughput and the latency percentiles seen by the client.
+//
+//   mbs_server_load [threads] [requests] [rows per request] [window] [mbs executable]
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../includes/mbs/server.h"
+
+using Clock = std::chrono::steady_clock;
+using namespace mbs::wire;
+
+namespace {
+    const std::string SOURCE = "qty * price > 100 && sku.startsWith('AB')";
+
+    template<typename T>
+    void write(std::string &out, const T val) {
+        auto bits = static_cast<std::make_unsigned_t<T> >(val);
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            out.push_back(static_cast<char>(bits & 0xff));
+            bits >>= 8;
+        }
+    }
+
+    void writeString(std::string &out, const std::string_view str) {
+        write(out, static_cast<uint32_t>(str.size()));
+        out.append(str);
+    }
+
+    template<typename T>
+    T read(const std::string &in, std::size_t &pos) {
+        std::make_unsigned_t<T> val = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            val |= static_cast<std::make_unsigned_t<T> >(static_cast<unsigned char>(in[pos++])) << (8 * i);
+        }
+        return static_cast<T>(val);
+    }
+
+    // Server process with its stdin and stdout as pipes
+    class Connection {
+    public:
+        Connection(const char *executable, const unsigned threads) {
+            int toServer[2], fromServer[2];
+            if (pipe(toServer) || pipe(fromServer)) throw std::runtime_error("pipe failed");
+
+            m_pid = fork();
+            if (m_pid < 0) throw std::runtime_error("fork failed");
+            if (m_pid == 0) {
+                dup2(toServer[0], STDIN_FILENO);
+                dup2(fromServer[1], STDOUT_FILENO);
+                close(toServer[1]);
+                close(fromServer[0]);
+                const auto arg = std::to_string(threads);
+                execl(executable, executable, "--serve", arg.c_str(), nullptr);
+                _exit(127);
+            }
+
+            close(toServer[0]);
+            close(fromServer[1]);
+            m_out = toServer[1];
+            m_in = fromServer[0];
+        }
+
+        ~Connection() {
+            close(m_out); // Ends the session, the server exits once it answered everything
+            close(m_in);
+            waitpid(m_pid, nullptr, 0);
+        }
+
+        void send(const std::string &payload) const {
+            std::string frame;
+            write(frame, static_cast<uint32_t>(payload.size()));
+            frame += payload;
+            writeAll(frame.data(), frame.size());
+        }
+
+        std::string receive() const {
+            std::string header(sizeof(uint32_t), '\0');
+            readAll(header.data(), header.size());
+            std::size_t pos = 0;
+            std::string payload(read<uint32_t>(header, pos), '\0');
+            readAll(payload.data(), payload.size());
+            return payload;
+        }
+
+    private:
+        void writeAll(const char *data, std::size_t size) const {
+            while (size) {
+                const auto n = ::write(m_out, data, size);
+                if (n <= 0) throw std::runtime_error("server closed its input");
+                data += n;
+                size -= static_cast<std::size_t>(n);
+            }
+        }
+
+        void readAll(char *data, std::size_t size) const {
+            while (size) {
+                const auto n = ::read(m_in, data, size);
+                if (n <= 0) throw std::runtime_error("server closed its output");
+                data += n;
+                size -= static_cast<std::size_t>(n);
+            }
+        }
+
+        pid_t m_pid;
+        int m_in, m_out;
+    };
+
+    std::string compileRequest(const uint32_t id) {
+        std::string request;
+        write(request, id);
+        write(request, static_cast<uint8_t>(Op::COMPILE));
+        writeString(request, SOURCE);
+        return request;
+    }
+
+    // Rows vary with `seed` so that requests don't all take the same branches
+    std::string evaluateRequest(const uint64_t handle, const uint32_t rows, const uint32_t seed) {
+        std::string request;
+        write(request, uint32_t{0}); // Id, patched per request
+        write(request, static_cast<uint8_t>(Op::EVALUATE));
+        write(request, handle);
+
+        write(request, uint32_t{3});
+        writeString(request, "qty");
+        writeString(request, "price");
+        writeString(request, "sku");
+
+        write(request, rows);
+        for (uint32_t row = 0; row < rows; ++row) {
+            write(request, static_cast<uint8_t>(Tag::INT));
+            write(request, static_cast<int64_t>((seed + row) % 20));
+            write(request, static_cast<uint8_t>(Tag::DOUBLE));
+            write(request, std::bit_cast<uint64_t>(9.5));
+            write(request, static_cast<uint8_t>(Tag::STRING));
+            writeString(request, (seed + row) % 3 ? "ABC" : "XYZ");
+        }
+        return request;
+    }
+
+    uint32_t arg(const int argc, char **argv, const int i, const uint32_t fallback) {
+        return argc > i ? static_cast<uint32_t>(std::strtoul(argv[i], nullptr, 10)) : fallback;
+    }
+}
+
+int main(const int argc, char **argv) {
+    const auto threads = arg(argc, argv, 1, std::max(std::thread::hardware_concurrency(), 1u));
+    const auto requests = std::max(arg(argc, argv, 2, 200000), 1u);
+    const auto rows = arg(argc, argv, 3, 1);
+    const auto window = std::max(arg(argc, argv, 4, 64), 1u);
+    const char *executable = argc > 5 ? argv[5] : MBS_EXECUTABLE;
+
+    const Connection server(executable, threads);
+
+    server.send(compileRequest(0));
+    const auto compiled = server.receive();
+    std::size_t pos = sizeof(uint32_t);
+    if (read<uint8_t>(compiled, pos) != static_cast<uint8_t>(Status::OK)) {
+        std::cerr << "Failed to compile `" << SOURCE << "`" << std::endl;
+        return 1;
+    }
+    const auto handle = read<uint64_t>(compiled, pos);
+
+    std::vector<std::string> payloads;
+    for (uint32_t seed = 0; seed < 64; ++seed) payloads.push_back(evaluateRequest(handle, rows, seed));
+
+    // Responses come back in any order, latencies are matched by id
+    std::vector<Clock::time_point> sent(requests);
+    std::vector<double> latencies;
+    latencies.reserve(requests);
+    std::atomic<uint32_t> received{0};
+
+    const auto start = Clock::now();
+    std::thread reader([&] {
+        for (uint32_t i = 0; i < requests; ++i) {
+            const auto response = server.receive();
+            std::size_t at = 0;
+            const auto id = read<uint32_t>(response, at);
+            latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - sent[id]).count());
+            received.store(i + 1, std::memory_order_release);
+        }
+    });
+
+    std::string request;
+    for (uint32_t i = 0; i < requests; ++i) {
+        while (i - received.load(std::memory_order_acquire) >= window) std::this_thread::yield();
+
+        request = payloads[i % payloads.size()];
+        std::string id;
+        write(id, i);
+        request.replace(0, id.size(), id);
+        sent[i] = Clock::now();
+        server.send(request);
+    }
+    reader.join();
+    const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&](const double p) {
+        return latencies[std::min(latencies.size() - 1, static_cast<std::size_t>(p * latencies.size()))];
+    };
+    std::cout << std::format("threads {}, {} rows/request, window {}: {:.0f} requests/s, {:.0f} evals/s\n",
+                             threads, rows, window, requests / seconds, requests * rows / seconds);
+    std::cout << std::format("latency p50 {:.1f} us, p99 {:.1f} us, p99.9 {:.1f} us\n",
+                             percentile(0.5), percentile(0.99), percentile(0.999));
+    return 0;
+}
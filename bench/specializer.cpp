@@ -0,0 +1,24 @@
+#include "bench.h"
+#include "../includes/mbs/backend/interpreter.h"
+#include "../includes/mbs/backend/specializer.h"
+#include "../includes/mbs/frontend/parser.h"
+
+// A tenant-wide rule specialized once per tenant, then evaluated for each request
+void bench::specializer() {
+    const Interpreter::Bindings tenant = {{"plan", "enterprise"}, {"seats", 250}, {"region", "eu"}};
+    Interpreter::Bindings request = tenant;
+    request.emplace("user", "u42");
+    request.emplace("usage", 180);
+
+    mbs::Parser parser;
+    parser.parse("(plan == 'enterprise' || plan == 'team') && region == 'eu' && usage * 100 / seats < 90"
+                 " && len(user) > 0");
+
+    const auto residual = specialize(parser.root(), tenant);
+    note(std::format("{} nodes folded away", residual.removedNodes));
+
+    Interpreter interp(request);
+    const auto full = run("full program", [&] { keep(interp.evaluate(parser.root())); });
+    run("residual program", [&] { keep(interp.evaluate(*residual.residual)); }, full);
+    run("specialize", [&] { keep(specialize(parser.root(), tenant)); });
+}
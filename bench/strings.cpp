@@ -0,0 +1,24 @@
+#include "bench.h"
+#include "../includes/mbs/backend/interpreter.h"
+#include "../includes/mbs/backend/type_checker.h"
+#include "../includes/mbs/frontend/parser.h"
+
+// `role == 'admin'`, with `role` bound to an interned string, which compares to the
+// literal by pointer, and to an uninterned copy compared by length, hash and bytes
+void bench::strings() {
+    mbs::Parser parser;
+    parser.parse("role == 'admin'");
+    TypeChecker({{"role", ValueType::STRING}}).check(parser.root());
+
+    const Interpreter::Bindings copied = {{"role", std::string("admin")}};
+    const Interpreter::Bindings interned = {{"role", RuntimeValue::interned("admin")}};
+    const Interpreter::Bindings other = {{"role", RuntimeValue::interned("owner")}};
+
+    Interpreter copiedInterp(copied);
+    Interpreter internedInterp(interned);
+    Interpreter otherInterp(other);
+
+    const auto base = run("uninterned, equal", [&] { keep(copiedInterp.evaluate(parser.root())); });
+    run("interned, equal", [&] { keep(internedInterp.evaluate(parser.root())); }, base);
+    run("interned, different", [&] { keep(otherInterp.evaluate(parser.root())); }, base);
+}
@@ -0,0 +1,23 @@
+#include "bench.h"
+#include "../includes/mbs/backend/interpreter.h"
+#include "../includes/mbs/backend/type_checker.h"
+#include "../includes/mbs/frontend/parser.h"
+
+// The same arithmetic predicate, with operand types unknown and then inferred
+void bench::typeChecker() {
+    const auto source = "a * b + c > d && a - c < b * 2.5 && d / b >= 1.5";
+    const Interpreter::Bindings bindings = {{"a", 12.5}, {"b", 3.0}, {"c", 7.25}, {"d", 40.0}};
+    Interpreter interp(bindings);
+
+    mbs::Parser dynamic;
+    dynamic.parse(source);
+
+    mbs::Parser typed;
+    typed.parse(source);
+    TypeChecker({
+        {"a", ValueType::NUMBER}, {"b", ValueType::NUMBER}, {"c", ValueType::NUMBER}, {"d", ValueType::NUMBER},
+    }).check(typed.root());
+
+    const auto base = run("runtime dispatch", [&] { keep(interp.evaluate(dynamic.root())); });
+    run("specialized operators", [&] { keep(interp.evaluate(typed.root())); }, base);
+}
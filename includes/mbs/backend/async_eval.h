@@ -0,0 +1,102 @@
+#ifndef MBSCRIPT_ASYNC_EVAL_H
+#define MBSCRIPT_ASYNC_EVAL_H
+
+#include <chrono>
+#include <coroutine>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "interpreter.h"
+#include "runtime.h"
+
+struct AstNode;
+class AstRoot;
+
+// Source of identifier values that aren't held in memory, such as records in storage
+class Resolver {
+public:
+    virtual ~Resolver();
+
+    // Resolves every key in a single round trip, `out[i]` receiving the value of
+    // `keys[i]`, or `nil` when there is none
+    virtual void resolve(std::span<const std::string> keys, std::span<RuntimeValue> out) = 0;
+};
+
+// Local stand-in for a remote resolver, optionally sleeping for `latency` per call
+class InMemoryResolver : public Resolver {
+public:
+    explicit InMemoryResolver(Interpreter::Bindings records, std::chrono::microseconds latency = {});
+
+    void resolve(std::span<const std::string> keys, std::span<RuntimeValue> out) override;
+
+    [[nodiscard]] std::size_t calls() const { return m_calls; }
+    [[nodiscard]] std::size_t keys() const { return m_keys; }
+
+private:
+    Interpreter::Bindings m_records;
+    std::chrono::microseconds m_latency;
+    std::size_t m_calls = 0;
+    std::size_t m_keys = 0;
+};
+
+// Evaluates many programs concurrently on the calling thread. Evaluation is a
+// coroutine that suspends on identifiers missing from the local bindings; once
+// every evaluation is either done or suspended, all pending lookups are
+// deduplicated and handed to the resolver in one call, and the waiting
+// evaluations resume with the results. Subtrees that only reference local
+// bindings are evaluated synchronously, and `&&`/`||` still short-circuit, so
+// no lookup is issued for a branch that isn't taken.
+class AsyncEvaluator {
+public:
+    struct Result {
+        RuntimeValue value;
+        std::optional<std::string> error; // Set when evaluation threw
+    };
+
+    explicit AsyncEvaluator(Resolver &resolver, const Interpreter::Bindings &local = {});
+    ~AsyncEvaluator();
+
+    // Queues `program` for the next `run()`, returning the index of its result.
+    // `program` must stay alive until `run()` returns.
+    std::size_t submit(AstRoot &program);
+
+    // Drives every queued evaluation to completion. Resolved values are shared
+    // by all evaluations of the same run, resolver errors propagate.
+    std::vector<Result> run();
+
+    // Resolver calls made over this evaluator's lifetime
+    [[nodiscard]] std::size_t batches() const { return m_batches; }
+
+private:
+    struct Task;
+    struct Evaluation;
+    class Lookup;
+
+    struct Waiter {
+        std::coroutine_handle<> handle;
+        RuntimeValue *slot;
+    };
+
+    Task evalProgram(AstRoot &program);
+    Task evalNode(AstNode &node);
+    // Whether the subtree references an identifier missing from the local bindings
+    bool isRemote(AstNode &node);
+    void resolvePending();
+    void reset();
+
+    Resolver &m_resolver;
+    Interpreter m_local;
+
+    std::vector<std::unique_ptr<Evaluation> > m_evaluations;
+    std::vector<std::coroutine_handle<> > m_ready;
+    std::unordered_map<std::string, std::vector<Waiter> > m_pending;
+    std::unordered_map<std::string, RuntimeValue> m_resolved;
+    std::unordered_map<const AstNode *, bool> m_remote;
+    std::size_t m_batches = 0;
+};
+
+#endif //MBSCRIPT_ASYNC_EVAL_H
@@ -0,0 +1,32 @@
+#ifndef MBSCRIPT_BUILTINS_H
+#define MBSCRIPT_BUILTINS_H
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+#include "runtime.h"
+
+// Built-in function callable as `f(x, ...)` or as a method `x.f(...)`, where the
+// receiver becomes the first argument.
+struct Builtin {
+    std::string name;
+    std::size_t minArgs, maxArgs;
+    // Pure builtins depend only on their arguments and may be constant folded
+    bool pure;
+    ValueType returns;
+    RuntimeValue (*fn)(std::span<const RuntimeValue> args);
+};
+
+// Calls are resolved to an index into this table at parse time, so evaluating
+// a call never looks a name up.
+namespace builtins {
+    // Most arguments any builtin takes, lets calls keep their arguments on the stack
+    constexpr std::size_t MAX_ARGS = 3;
+
+    // Index of the builtin called `name`, -1 if there is none
+    int indexOf(const std::string &name);
+    const Builtin &at(int index);
+}
+
+#endif //MBSCRIPT_BUILTINS_H
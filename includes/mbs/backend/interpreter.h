@@ -1,6 +1,135 @@
 #ifndef MBSCRIPT_INTERPRETER_H
 #define MBSCRIPT_INTERPRETER_H
 
-class Interpreter {};
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
 
-#endif //MBSCRIPT_INTERPRETER_H
\ No newline at end of file
+#include "pattern.h"
+#include "runtime.h"
+
+struct AstNode;
+class AstRoot;
+
+// Limits for evaluating untrusted expressions, zero meaning unlimited. A step is
+// one operator, member access, call or match; memory counts the bytes of every
+// string built while evaluating, whether or not it's still alive.
+struct EvalBudget {
+    enum class Limit: uint8_t {
+        NONE,
+        STEPS,
+        MEMORY,
+        DEADLINE,
+    };
+
+    uint64_t maxSteps = 0;
+    std::size_t maxMemory = 0;
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+};
+
+const char *limitToString(EvalBudget::Limit limit);
+
+// Thrown from inside evaluation to unwind once a budget is exhausted
+class BudgetExceeded : public std::runtime_error {
+public:
+    explicit BudgetExceeded(EvalBudget::Limit limit);
+
+    [[nodiscard]] EvalBudget::Limit limit() const { return m_limit; }
+
+private:
+    EvalBudget::Limit m_limit;
+};
+
+struct BudgetedResult {
+    RuntimeValue value; // `nil` when a limit was exceeded
+    EvalBudget::Limit exceeded = EvalBudget::Limit::NONE;
+    uint64_t steps = 0;
+    std::size_t memory = 0;
+};
+
+// Caller-owned buffers for evaluating without allocating, reuse one across calls.
+// Once they have grown to fit a program, numeric, boolean and string-compare
+// expressions evaluate without touching the heap; only building new strings
+// (concatenation, `lower`, `upper`, `std::string` host fields) still allocates.
+struct EvalScratch {
+    std::vector<RuntimeValue> results; // Result of each top-level expression
+    Pattern::Scratch pattern;
+};
+
+class Interpreter {
+public:
+    using Bindings = std::unordered_map<std::string, RuntimeValue>;
+    // Reads one field of a host object, see `IdentifierExpr::bindSlot`
+    using SlotReader = RuntimeValue (*)(const void *host);
+
+    // The deadline is only read from the clock once every this many steps
+    static constexpr uint64_t DEADLINE_CHECK_INTERVAL = 1024;
+
+    Interpreter();
+    explicit Interpreter(const Bindings &bindings);
+    // Identifiers bound to slot `i` read `readers[i](host)`, others resolve to `nil`
+    Interpreter(const void *host, const SlotReader *readers);
+
+    // Evaluates a single expression against the current bindings
+    RuntimeValue evaluate(AstNode &node);
+    // Evaluates every top-level expression, returning the last result
+    RuntimeValue evaluate(AstRoot &root);
+    // Same as `evaluate` but stops as soon as `budget` is exceeded, reporting which
+    // limit was hit instead of throwing. Other evaluation errors still throw.
+    BudgetedResult evaluate(AstRoot &root, const EvalBudget &budget);
+    // Evaluates every top-level expression into `scratch.results`, returning them
+    std::span<const RuntimeValue> evaluate(AstRoot &root, EvalScratch &scratch);
+    // Both of the above, the result being the last one written into `scratch`
+    BudgetedResult evaluate(AstRoot &root, const EvalBudget &budget, EvalScratch &scratch);
+
+    // Unbound identifiers resolve to `nil`
+    [[nodiscard]] RuntimeValue lookup(const std::string &ident) const;
+    // Same as `lookup` without copying the value, `nullptr` when unbound
+    [[nodiscard]] const RuntimeValue *find(const std::string &ident) const;
+
+    [[nodiscard]] bool hasHost() const { return m_readers != nullptr; }
+    [[nodiscard]] RuntimeValue slot(const uint32_t index) const { return m_readers[index](m_host); }
+
+    // Buffers for `~=` when evaluating into an `EvalScratch`, `nullptr` otherwise
+    [[nodiscard]] Pattern::Scratch *patternScratch() const { return m_patternScratch; }
+
+    // Accounts one evaluation step, called by every non-leaf node
+    void step() {
+        if (--m_fuel == 0) [[unlikely]] refuel();
+    }
+
+    // Accounts a string built during evaluation against the memory budget
+    void charge(const RuntimeValue &built) {
+        if (m_budget.maxMemory && built.isString()) chargeBytes(built.asString().size());
+    }
+
+private:
+    static constexpr uint64_t UNLIMITED = std::numeric_limits<uint64_t>::max();
+
+    // Runs `evaluate` under `budget`, its result becoming the value
+    template<typename Evaluate>
+    BudgetedResult budgeted(const EvalBudget &budget, Evaluate &&evaluate);
+
+    void refuel();
+    void grant();
+    void chargeBytes(std::size_t bytes);
+
+    const Bindings *m_bindings;
+    const void *m_host = nullptr;
+    const SlotReader *m_readers = nullptr;
+    Pattern::Scratch *m_patternScratch = nullptr;
+
+    // Steps left until the next budget checkpoint; without a budget it never runs out
+    uint64_t m_fuel = UNLIMITED;
+    uint64_t m_steps = 0; // Steps taken before the current refuel
+    uint64_t m_granted = UNLIMITED;
+    std::size_t m_memory = 0;
+    EvalBudget m_budget;
+};
+
+#endif //MBSCRIPT_INTERPRETER_H
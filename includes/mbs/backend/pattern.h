@@ -0,0 +1,94 @@
+#ifndef MBSCRIPT_PATTERN_H
+#define MBSCRIPT_PATTERN_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Compiled `~=` pattern. Patterns always match the whole subject and support
+// literals, `.`, `[...]`/`[^...]` classes, `\d \w \s` (and their negations),
+// escapes, grouping, `|`, `*`, `+` and `?`. A leading `^` or trailing `$` is
+// accepted and ignored.
+//
+// Patterns that are plain literals, optionally wrapped in `.*`, are matched
+// with string compares and searches. Everything else is compiled into a DFA,
+// or simulated as an NFA when the DFA would grow too large; either way
+// matching runs in time linear in the subject, with no backtracking.
+class Pattern {
+public:
+    enum class Kind : uint8_t { EXACT, PREFIX, SUFFIX, SUBSTRING, DFA, NFA };
+
+    // Patterns may come from scripts at runtime, longer or more deeply nested ones
+    // are rejected rather than risking the compiler's stack
+    static constexpr std::size_t MAX_LENGTH = 64 * 1024;
+    static constexpr int MAX_GROUP_DEPTH = 256;
+
+    // State sets of the NFA simulation, reusable across matches of any pattern
+    struct Scratch {
+        std::vector<int> current, next, pending;
+        std::vector<uint8_t> onList;
+    };
+
+    // Throws `std::runtime_error` on malformed patterns and ones over the limits above
+    static std::shared_ptr<const Pattern> compile(std::string_view source);
+
+    [[nodiscard]] bool matches(std::string_view subject) const;
+    // Same as `matches`, without allocating once `scratch` has grown to fit the pattern
+    [[nodiscard]] bool matches(std::string_view subject, Scratch &scratch) const;
+
+    [[nodiscard]] Kind kind() const { return m_kind; }
+    [[nodiscard]] const std::string &source() const { return m_source; }
+
+private:
+    struct NfaState {
+        enum class Type : uint8_t { BYTES, SPLIT, MATCH } type = Type::SPLIT;
+        std::array<uint64_t, 4> bytes{}; // Byte set consumed by `BYTES` states
+        int out = -1, out1 = -1;
+    };
+
+    friend class PatternCompiler;
+
+    bool buildDfa();
+    void closure(std::vector<int> &states, std::vector<uint8_t> &onList, std::vector<int> &pending, int state) const;
+    [[nodiscard]] bool simulateNfa(std::string_view subject, Scratch &scratch) const;
+
+    Kind m_kind = Kind::NFA;
+    std::string m_source;
+    std::string m_literal; // Literal part for the string fast paths
+
+    std::vector<NfaState> m_nfa;
+    int m_nfaStart = -1;
+
+    // `m_transitions[state * 256 + byte]`, -1 is the dead state
+    std::vector<int32_t> m_transitions;
+    std::vector<uint8_t> m_accepting;
+};
+
+// Bounded LRU cache sharing compiled patterns between programs
+class PatternCache {
+public:
+    explicit PatternCache(std::size_t capacity);
+
+    static PatternCache &global();
+
+    std::shared_ptr<const Pattern> get(std::string_view source);
+
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    using Entry = std::pair<std::string, std::shared_ptr<const Pattern> >;
+
+    mutable std::mutex m_mutex;
+    std::size_t m_capacity;
+    std::list<Entry> m_lru; // Most recently used first
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> m_index;
+};
+
+#endif //MBSCRIPT_PATTERN_H
@@ -0,0 +1,125 @@
+#ifndef MBSCRIPT_PROFILER_H
+#define MBSCRIPT_PROFILER_H
+
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct AstNode;
+
+// Collects per-node evaluation counts and cycles plus lex/parse/compile/eval phase
+// timings. The hooks (`MBS_PROFILE_NODE`, `MBS_PROFILE_PHASE`) are only compiled in
+// when building with `MBS_PROFILE`, and record into the profiler made active on the
+// current thread by a `Profiler::Session`.
+//
+// Nodes are keyed by address, so `reset()` before profiling a different tree.
+class Profiler {
+public:
+    enum class Phase: uint8_t {
+        LEX,
+        PARSE,
+        COMPILE,
+        EVAL,
+    };
+
+    static constexpr std::size_t NO_PARENT = std::numeric_limits<std::size_t>::max();
+
+    struct NodeStats {
+        std::string label;
+        std::size_t parent = NO_PARENT; // Index of the enclosing node's stats
+        uint64_t count = 0;
+        uint64_t cycles = 0;     // Including children
+        uint64_t selfCycles = 0; // Excluding children
+    };
+
+    struct PhaseStats {
+        uint64_t calls = 0;
+        uint64_t nanos = 0;
+    };
+
+#ifdef MBS_PROFILE
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    // Makes `profiler` the current thread's active profiler for its lifetime
+    class Session {
+    public:
+        explicit Session(Profiler &profiler);
+        ~Session();
+        Session(const Session &) = delete;
+        Session &operator=(const Session &) = delete;
+
+    private:
+        Profiler *m_previous;
+    };
+
+    class NodeScope {
+    public:
+        explicit NodeScope(const AstNode &node);
+        ~NodeScope();
+        NodeScope(const NodeScope &) = delete;
+        NodeScope &operator=(const NodeScope &) = delete;
+
+    private:
+        Profiler *m_profiler;
+    };
+
+    class PhaseScope {
+    public:
+        explicit PhaseScope(Phase phase);
+        ~PhaseScope();
+        PhaseScope(const PhaseScope &) = delete;
+        PhaseScope &operator=(const PhaseScope &) = delete;
+
+    private:
+        Profiler *m_profiler;
+        Phase m_phase;
+        uint64_t m_start = 0;
+    };
+
+    // `nullptr` outside of a `Session`
+    static Profiler *active();
+
+    void enter(const AstNode &node);
+    void leave();
+    void recordPhase(Phase phase, uint64_t nanos);
+    void reset();
+
+    [[nodiscard]] const std::vector<NodeStats> &nodes() const { return m_nodes; }
+    [[nodiscard]] const PhaseStats &phase(const Phase phase) const { return m_phases[static_cast<int>(phase)]; }
+    // Indices into `nodes()` of the `n` nodes with the most self cycles
+    [[nodiscard]] std::vector<std::size_t> hottest(std::size_t n) const;
+
+    void writeJson(std::ostream &out) const;
+    // One `root;child;leaf <self cycles>` line per node, as consumed by flamegraph.pl
+    void writeFolded(std::ostream &out) const;
+
+private:
+    struct Frame {
+        std::size_t stats;
+        uint64_t start;
+        uint64_t children = 0;
+    };
+
+    std::unordered_map<const AstNode *, std::size_t> m_index;
+    std::vector<NodeStats> m_nodes;
+    std::vector<Frame> m_stack;
+    PhaseStats m_phases[4]{};
+};
+
+const char *phaseToString(Profiler::Phase phase);
+
+#ifdef MBS_PROFILE
+#define MBS_PROFILE_NODE(node) const Profiler::NodeScope mbsProfileNode_(node)
+#define MBS_PROFILE_PHASE(phase) const Profiler::PhaseScope mbsProfilePhase_(phase)
+#else
+#define MBS_PROFILE_NODE(node) ((void) 0)
+#define MBS_PROFILE_PHASE(phase) ((void) 0)
+#endif
+
+#endif //MBSCRIPT_PROFILER_H
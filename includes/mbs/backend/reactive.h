@@ -0,0 +1,69 @@
+#ifndef MBSCRIPT_REACTIVE_H
+#define MBSCRIPT_REACTIVE_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "interpreter.h"
+#include "runtime.h"
+
+struct AstNode;
+
+// Keeps the last value of every subtree of a set of expressions and, when a
+// binding changes, only recomputes the subtrees depending on it. Each identifier
+// node is indexed by name, and `set` marks it and its ancestors dirty; reading a
+// value then recomputes dirty nodes from the cached values of their children.
+class ReactiveEvaluator {
+public:
+    using ExprId = std::size_t;
+
+    explicit ReactiveEvaluator(Interpreter::Bindings bindings = {});
+    ReactiveEvaluator(const ReactiveEvaluator &) = delete;
+    ReactiveEvaluator &operator=(const ReactiveEvaluator &) = delete;
+
+    // Tracks `expr`, which must outlive the evaluator
+    ExprId add(AstNode &expr);
+    // Rebinds `name`, invalidating every expression depending on it
+    void set(const std::string &name, RuntimeValue value);
+
+    // Current value of `id`, recomputing whatever changed since it was last read
+    const RuntimeValue &value(ExprId id);
+    // Identifiers `id` depends on, sorted
+    [[nodiscard]] std::vector<std::string> dependencies(ExprId id) const;
+
+    // Nodes evaluated vs. nodes whose cached value was used, since the last reset
+    [[nodiscard]] std::size_t recomputed() const { return m_recomputed; }
+    [[nodiscard]] std::size_t reused() const { return m_reused; }
+    void resetCounters();
+
+private:
+    static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+    struct Memo {
+        AstNode *node;
+        uint32_t parent = NO_PARENT;
+        uint8_t arity = 0;
+        bool dirty = true;
+        std::array<uint32_t, 3> children{};
+        RuntimeValue value;
+    };
+
+    uint32_t track(AstNode &node, uint32_t parent);
+    const RuntimeValue &compute(uint32_t index);
+
+    Interpreter::Bindings m_bindings;
+    Interpreter m_interp;
+
+    std::vector<Memo> m_memos;
+    std::vector<uint32_t> m_roots;
+    // Identifier nodes by the name they read
+    std::unordered_map<std::string, std::vector<uint32_t> > m_readers;
+
+    std::size_t m_recomputed = 0;
+    std::size_t m_reused = 0;
+};
+
+#endif //MBSCRIPT_REACTIVE_H
@@ -0,0 +1,83 @@
+#ifndef MBSCRIPT_RULE_INDEX_H
+#define MBSCRIPT_RULE_INDEX_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "interpreter.h"
+#include "runtime.h"
+
+struct AstNode;
+
+// Indexes many stored rule expressions so a record only has to be checked
+// against the rules that can possibly match it.
+//
+// Each rule is reduced to a set of "guard" atoms (`ident == lit`, `ident < lit`, ...)
+// such that the rule can only be true if one of its guards is. Equality guards are
+// kept in hash maps, range guards in sorted threshold arrays, and rules with no
+// usable guard are always checked.
+class RuleIndex {
+public:
+    using RuleId = std::size_t;
+
+    RuleIndex();
+    ~RuleIndex();
+
+    // `source` must hold exactly one top-level expression
+    RuleId addRule(const std::string &source);
+    RuleId addRule(std::unique_ptr<AstNode> rule);
+
+    // Superset of the rules matching `record`, in ascending id order
+    [[nodiscard]] std::vector<RuleId> candidates(const Interpreter::Bindings &record);
+    // Rules evaluating truthy against `record`, rules failing to evaluate don't match
+    [[nodiscard]] std::vector<RuleId> match(const Interpreter::Bindings &record);
+
+    [[nodiscard]] std::size_t size() const { return m_rules.size(); }
+    [[nodiscard]] std::size_t unindexedCount() const { return m_unindexed.size(); }
+
+private:
+    enum class RangeOp : uint8_t { LESS, LESS_OR_EQUALS, GREATER, GREATER_OR_EQUALS };
+
+    struct Atom {
+        std::string ident;
+        std::string op;
+        RuntimeValue value;
+    };
+
+    template<typename T>
+    struct Thresholds {
+        std::vector<std::pair<T, RuleId> > entries;
+        bool sorted = true;
+    };
+
+    struct RangeIndex {
+        std::array<Thresholds<RuntimeValue>, 4> numbers; // Compared exactly, see `compareNumbers`
+        std::array<Thresholds<std::string>, 4> strings;
+    };
+
+    static std::optional<std::vector<Atom> > guardsOf(const AstNode &node);
+    static std::optional<Atom> atomOf(const AstNode &node);
+
+    void indexAtom(const Atom &atom, RuleId id);
+    void collect(RuleId id, std::vector<RuleId> &out);
+
+    template<typename T, typename Less>
+    void collectRange(Thresholds<T> &bounds, RangeOp op, const T &val, Less less, std::vector<RuleId> &out);
+
+    std::vector<std::unique_ptr<AstNode> > m_rules;
+    std::vector<RuleId> m_unindexed;
+    std::unordered_map<std::string, std::unordered_map<RuntimeValue, std::vector<RuleId>, RuntimeValueHash> > m_equality;
+    std::unordered_map<std::string, RangeIndex> m_ranges;
+
+    // Per-query dedup stamps, a rule guarded by several atoms is reported once
+    std::vector<uint64_t> m_seen;
+    uint64_t m_epoch = 0;
+};
+
+#endif //MBSCRIPT_RULE_INDEX_H
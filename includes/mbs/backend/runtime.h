@@ -1,6 +1,134 @@
 #ifndef MBSCRIPT_RUNTIME_H
 #define MBSCRIPT_RUNTIME_H
 
-struct RuntimeValue {};
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
 
-#endif //MBSCRIPT_RUNTIME_H
\ No newline at end of file
+#include "strings.h"
+
+// Static type of an expression, `ANY` when only known at evaluation time
+enum class ValueType : uint8_t {
+    ANY,
+    NIL,
+    BOOL,
+    NUMBER,
+    STRING,
+    OBJECT,
+};
+
+std::string valueTypeToString(ValueType vt);
+
+// Field layout shared by host objects of the same kind. Every shape gets a unique
+// id so member accesses can cache field indices per shape instead of hashing names.
+class Shape {
+public:
+    struct Field {
+        std::string name;
+        ValueType type = ValueType::ANY;
+        std::shared_ptr<const Shape> shape; // Layout of the nested object, if known
+    };
+
+    explicit Shape(std::vector<Field> fields);
+
+    [[nodiscard]] uint32_t id() const { return m_id; }
+    [[nodiscard]] const std::vector<Field> &fields() const { return m_fields; }
+    // Position of `name` in `fields()`, -1 when the shape has no such field
+    [[nodiscard]] int indexOf(const std::string &name) const;
+
+private:
+    uint32_t m_id;
+    std::vector<Field> m_fields;
+    std::unordered_map<std::string, int> m_index;
+};
+
+struct ObjectValue;
+
+struct RuntimeValue {
+    using Value = std::variant<std::monostate, bool, double, int64_t, StringValue,
+        std::shared_ptr<const ObjectValue> >;
+
+    RuntimeValue() = default;
+    RuntimeValue(bool val);
+    RuntimeValue(double val);
+    RuntimeValue(int val);
+    RuntimeValue(int64_t val);
+    RuntimeValue(std::string val);
+    RuntimeValue(const char *val);
+    RuntimeValue(StringValue val);
+
+    // String value interned in the global `StringInterner` for good, for a small set of
+    // values bound repeatedly
+    static RuntimeValue interned(std::string_view val);
+
+    // Host object laid out as `shape`, `fields` must match `shape->fields()` one to one
+    static RuntimeValue object(std::shared_ptr<const Shape> shape, std::vector<RuntimeValue> fields);
+
+    [[nodiscard]] bool isNull() const { return std::holds_alternative<std::monostate>(value); }
+    [[nodiscard]] bool isBool() const { return std::holds_alternative<bool>(value); }
+    // Numbers are exact integers when integral, doubles otherwise
+    [[nodiscard]] bool isNumber() const { return isInt() || std::holds_alternative<double>(value); }
+    [[nodiscard]] bool isInt() const { return std::holds_alternative<int64_t>(value); }
+    [[nodiscard]] bool isString() const { return std::holds_alternative<StringValue>(value); }
+    [[nodiscard]] bool isObject() const { return std::holds_alternative<std::shared_ptr<const ObjectValue> >(value); }
+    // Dynamic type of the value, never `ANY`
+    [[nodiscard]] ValueType type() const {
+        constexpr ValueType types[] = {
+            ValueType::NIL, ValueType::BOOL, ValueType::NUMBER, ValueType::NUMBER, ValueType::STRING, ValueType::OBJECT,
+        };
+        return types[value.index()];
+    }
+
+    [[nodiscard]] bool asBool() const { return std::get<bool>(value); }
+    [[nodiscard]] double asNumber() const {
+        return isInt() ? static_cast<double>(std::get<int64_t>(value)) : std::get<double>(value);
+    }
+    [[nodiscard]] int64_t asInt() const { return std::get<int64_t>(value); }
+    [[nodiscard]] const std::string &asString() const { return std::get<StringValue>(value).str(); }
+    [[nodiscard]] const StringValue &asStringValue() const { return std::get<StringValue>(value); }
+    [[nodiscard]] const ObjectValue &asObject() const { return *std::get<std::shared_ptr<const ObjectValue> >(value); }
+
+    // `nil`, `false`, `0` and `''` are falsy, everything else (objects included) is truthy
+    [[nodiscard]] bool isTruthy() const;
+    [[nodiscard]] std::string typeName() const;
+    [[nodiscard]] std::string toString() const;
+    // Copy whose string no longer refers to an interned entry, so it can outlive the
+    // string literal it may come from
+    [[nodiscard]] RuntimeValue detached() const;
+
+    friend bool operator==(const RuntimeValue &lhs, const RuntimeValue &rhs);
+
+    Value value;
+};
+
+struct ObjectValue {
+    std::shared_ptr<const Shape> shape;
+    std::vector<RuntimeValue> fields; // In `shape->fields()` order
+};
+
+struct RuntimeValueHash {
+    std::size_t operator()(const RuntimeValue &val) const noexcept;
+};
+
+// Exact ordering of two numbers, integers are never rounded through a double
+std::partial_ordering compareNumbers(const RuntimeValue &lhs, const RuntimeValue &rhs);
+
+// Applies a (non short-circuiting) operator to already evaluated operands,
+// throws `std::runtime_error` on operand type mismatches. Integer `+ - * % **`
+// stay integers and only fall back to doubles when the result overflows.
+RuntimeValue applyUnaryOp(const std::string &op, const RuntimeValue &operand);
+RuntimeValue applyBinaryOp(const std::string &op, const RuntimeValue &lhs, const RuntimeValue &rhs);
+
+// Binary operator implementation without operand type checks, see `specializedBinaryOp`
+using BinaryOpFn = RuntimeValue (*)(const RuntimeValue &lhs, const RuntimeValue &rhs);
+
+// Returns an operator specialized for operands statically known to be of `lhs` and `rhs`
+// types, or `nullptr` when there is none and `applyBinaryOp` must be used instead.
+BinaryOpFn specializedBinaryOp(const std::string &op, ValueType lhs, ValueType rhs);
+
+#endif //MBSCRIPT_RUNTIME_H
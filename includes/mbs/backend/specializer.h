@@ -0,0 +1,31 @@
+#ifndef MBSCRIPT_SPECIALIZER_H
+#define MBSCRIPT_SPECIALIZER_H
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+
+#include "interpreter.h"
+#include "runtime.h"
+
+class AstRoot;
+
+struct Specialization {
+    // Program left to evaluate once the unknown identifiers are bound
+    std::unique_ptr<AstRoot> residual;
+    // AST nodes folded away compared to the input program
+    std::size_t removedNodes = 0;
+    // Set when the program result no longer depends on any unknown identifier
+    std::optional<RuntimeValue> constant;
+};
+
+// Partially evaluates `program` against the identifiers in `known`, folding every
+// subtree that only depends on them (calls only when the builtin is pure). Identifiers missing from `known` stay symbolic.
+// Subtrees that can't affect the result (`x && false`) are dropped even if evaluating
+// them would have failed; subtrees that fail on known values are kept as is so the
+// error still surfaces at evaluation time. Object values have no literal form, so
+// object-valued expressions that aren't folded further keep referring to their
+// known identifiers, which must then stay bound when evaluating the residual.
+Specialization specialize(const AstRoot &program, const Interpreter::Bindings &known);
+
+#endif //MBSCRIPT_SPECIALIZER_H
@@ -0,0 +1,18 @@
+#ifndef MBSCRIPT_STRING_KERNELS_H
+#define MBSCRIPT_STRING_KERNELS_H
+
+#include <cstddef>
+#include <string_view>
+
+// Byte-level string kernels backing the string builtins. They use AVX2 when the
+// build targets it, SSE2 on any other x86-64 build, and plain loops elsewhere.
+namespace kernels {
+    // Offset of the first occurrence of `needle` in `haystack`, `npos` if absent
+    std::size_t find(std::string_view haystack, std::string_view needle);
+
+    // ASCII case folding of `n` bytes from `src` into `dst`, other bytes are copied as is
+    void toLower(const char *src, char *dst, std::size_t n);
+    void toUpper(const char *src, char *dst, std::size_t n);
+}
+
+#endif //MBSCRIPT_STRING_KERNELS_H
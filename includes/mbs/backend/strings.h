@@ -0,0 +1,90 @@
+#ifndef MBSCRIPT_STRINGS_H
+#define MBSCRIPT_STRINGS_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+class StringInterner;
+
+// Immutable string payload with its hash and length computed once up front
+struct StringEntry {
+    StringEntry(std::string text, const StringInterner *domain);
+
+    std::string text;
+    std::size_t hash;
+    const StringInterner *domain; // Interner owning this entry, `nullptr` if not interned
+    std::size_t pins = 0; // Live `StringInterner::pin` handles, guarded by the interner
+    bool permanent = false; // Handed out by `StringInterner::intern`, never dropped
+};
+
+// String handle used by runtime values. Interned strings point into their interner
+// and are copied as a plain pointer; other strings own a shared, uninterned entry.
+class StringValue {
+public:
+    explicit StringValue(std::string text);
+
+    [[nodiscard]] const std::string &str() const { return m_entry->text; }
+    [[nodiscard]] std::size_t hash() const { return m_entry->hash; }
+    [[nodiscard]] std::size_t size() const { return m_entry->text.size(); }
+    [[nodiscard]] bool isInterned() const { return m_entry->domain != nullptr; }
+
+    // Uninterned copy, for values that may outlive the handle's pin
+    [[nodiscard]] StringValue detached() const;
+
+    // Strings interned in the same domain are equal only if they are the same entry,
+    // otherwise length, hash and finally the bytes are compared.
+    friend bool operator==(const StringValue &lhs, const StringValue &rhs) {
+        if (lhs.m_entry == rhs.m_entry) return true;
+        if (lhs.m_entry->domain && lhs.m_entry->domain == rhs.m_entry->domain) return false;
+        return lhs.hash() == rhs.hash() && lhs.str() == rhs.str();
+    }
+
+    friend auto operator<=>(const StringValue &lhs, const StringValue &rhs) {
+        return lhs.str() <=> rhs.str();
+    }
+
+private:
+    friend class StringInterner;
+    explicit StringValue(const StringEntry *entry);
+
+    const StringEntry *m_entry;
+    std::shared_ptr<const StringEntry> m_owned; // Keeps uninterned entries alive
+};
+
+// Deduplicates strings so equal strings share one entry. Handles are plain pointers,
+// so an entry's lifetime is tracked by what owns it: `intern` keeps it for as long as
+// the interner, while `pin` keeps it until the matching `unpin`.
+class StringInterner {
+public:
+    StringInterner() = default;
+    StringInterner(const StringInterner &) = delete;
+    StringInterner &operator=(const StringInterner &) = delete;
+
+    // Interner used for string literals and bound string values
+    static StringInterner &global();
+
+    StringValue intern(std::string_view text);
+    // For strings owned by something shorter-lived, such as a string literal: the entry
+    // is dropped with its last pin, unless it was also interned for good
+    StringValue pin(std::string_view text);
+    void unpin(const StringValue &value);
+
+    [[nodiscard]] std::size_t size() const;
+    // Approximate heap footprint of the table: entries, string payloads and buckets
+    [[nodiscard]] std::size_t memoryUsage() const;
+
+private:
+    // Entry for `text`, added if missing, the lock must be held
+    StringEntry &find(std::string_view text);
+    static std::size_t footprint(const StringEntry &entry);
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string_view, std::unique_ptr<StringEntry> > m_entries;
+    std::size_t m_payloadBytes = 0;
+};
+
+#endif //MBSCRIPT_STRINGS_H
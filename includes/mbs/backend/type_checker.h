@@ -0,0 +1,41 @@
+#ifndef MBSCRIPT_TYPE_CHECKER_H
+#define MBSCRIPT_TYPE_CHECKER_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "runtime.h"
+
+struct AstNode;
+class AstRoot;
+
+// Infers the static type of every node from literal types and an optional schema
+// of identifier types, annotating `AstNode::valueType`. Binary expressions whose
+// operand types are fully known get a specialized operator that skips runtime
+// type dispatch, and operand mismatches such as `'a' - 1` are reported up front.
+// Member paths on identifiers with a known shape are resolved to field indices.
+class TypeChecker {
+public:
+    using Schema = std::unordered_map<std::string, ValueType>;
+    using Shapes = std::unordered_map<std::string, std::shared_ptr<const Shape> >;
+
+    TypeChecker() = default;
+    explicit TypeChecker(Schema schema, Shapes shapes = {});
+
+    // Annotates `program` in place, returning one message per type error
+    std::vector<std::string> check(AstRoot &program);
+
+private:
+    ValueType infer(AstNode &node);
+    ValueType inferUnary(AstNode &node);
+    ValueType inferBinary(AstNode &node);
+    ValueType inferMember(AstNode &node);
+
+    Schema m_schema;
+    Shapes m_shapes;
+    std::vector<std::string> m_errors;
+};
+
+#endif //MBSCRIPT_TYPE_CHECKER_H
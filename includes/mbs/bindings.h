@@ -0,0 +1,101 @@
+#ifndef MBSCRIPT_BINDINGS_H
+#define MBSCRIPT_BINDINGS_H
+
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "backend/interpreter.h"
+#include "backend/runtime.h"
+
+namespace mbs {
+    // One field of a host struct exposed to scripts under `name`
+    template<typename T, typename M>
+    struct Field {
+        using type = M;
+
+        std::string_view name;
+        M T::*member;
+    };
+
+    template<typename T, typename M>
+    constexpr Field<T, M> field(const std::string_view name, M T::*member) {
+        return {name, member};
+    }
+
+    // Specialize for a host struct to expose its fields, e.g.
+    //
+    //   template<> struct mbs::Fields<Order> {
+    //       static constexpr auto list = std::tuple{
+    //           mbs::field("qty", &Order::qty),
+    //           mbs::field("price", &Order::price),
+    //       };
+    //   };
+    //
+    // Fields may be `bool`, arithmetic, `std::string`, `StringValue` or `RuntimeValue`.
+    // Reading a `std::string` field copies it; a `StringValue` (e.g. interned) is
+    // shared instead, which keeps evaluation free of allocations.
+    template<typename T>
+    struct Fields;
+
+    template<typename M>
+    constexpr ValueType valueTypeOf() {
+        if constexpr (std::same_as<M, bool>) return ValueType::BOOL;
+        else if constexpr (std::is_arithmetic_v<M>) return ValueType::NUMBER;
+        else if constexpr (std::same_as<M, std::string> || std::same_as<M, StringValue>) return ValueType::STRING;
+        else if constexpr (std::same_as<M, RuntimeValue>) return ValueType::ANY;
+        else static_assert(!sizeof(M), "Unsupported host field type");
+    }
+
+    template<typename M>
+    RuntimeValue toRuntimeValue(const M &val) {
+        if constexpr (std::same_as<M, bool> || std::same_as<M, StringValue> || std::same_as<M, RuntimeValue>) return val;
+        else if constexpr (std::is_unsigned_v<M> && sizeof(M) >= sizeof(int64_t)) {
+            // Like integer overflow in scripts, values beyond `int64_t` fall back to doubles
+            if (val > static_cast<M>(INT64_MAX)) return static_cast<double>(val);
+            return static_cast<int64_t>(val);
+        } else if constexpr (std::is_integral_v<M>) return static_cast<int64_t>(val);
+        else if constexpr (std::is_floating_point_v<M>) return static_cast<double>(val);
+        else return RuntimeValue(val);
+    }
+
+    // Name and type of a host field, in slot order
+    struct HostField {
+        std::string_view name;
+        ValueType type;
+    };
+
+    template<typename T>
+    struct HostLayout {
+        static constexpr std::size_t size = std::tuple_size_v<std::remove_cvref_t<decltype(Fields<T>::list)> >;
+
+        template<std::size_t I>
+        using FieldAt = std::remove_cvref_t<std::tuple_element_t<I, std::remove_cvref_t<decltype(Fields<T>::list)> > >;
+
+        // `readers[i]` loads field `i` directly, the member pointer being a constant
+        static constexpr auto readers = []<std::size_t... I>(std::index_sequence<I...>) {
+            return std::array<Interpreter::SlotReader, size>{
+                +[](const void *host) {
+                    constexpr auto f = std::get<I>(Fields<T>::list);
+                    return toRuntimeValue(static_cast<const T *>(host)->*f.member);
+                }...
+            };
+        }(std::make_index_sequence<size>{});
+
+        static std::vector<HostField> fields() {
+            return []<std::size_t... I>(std::index_sequence<I...>) {
+                return std::vector<HostField>{
+                    HostField{std::get<I>(Fields<T>::list).name, valueTypeOf<typename FieldAt<I>::type>()}...
+                };
+            }(std::make_index_sequence<size>{});
+        }
+    };
+}
+
+#endif //MBSCRIPT_BINDINGS_H
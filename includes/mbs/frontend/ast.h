@@ -1,13 +1,19 @@
 #ifndef MBSCRIPT_AST_H
 #define MBSCRIPT_AST_H
 
+#include <atomic>
 #include <memory>
-#include <sstream>
+#include <memory_resource>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "../backend/builtins.h"
+#include "../backend/pattern.h"
 #include "../backend/runtime.h"
 
+class Interpreter;
+
 enum class NodeType: uint8_t {
     PROGRAM,
     STRING_LITERAL,
@@ -17,16 +23,21 @@ enum class NodeType: uint8_t {
     IDENTIFIER,
     UNARY_EXPR,
     BINARY_EXPR,
+    MEMBER_EXPR,
+    CALL_EXPR,
+    MATCH_EXPR,
 };
 
 struct AstNode {
     std::string name;
     NodeType type;
+    ValueType valueType = ValueType::ANY; // Annotated by the `TypeChecker`
 
     AstNode(std::string name, NodeType type);
     virtual ~AstNode();
-    virtual RuntimeValue eval() = 0;
-    virtual std::string toString() = 0;
+    virtual RuntimeValue eval(Interpreter &interp) = 0;
+    // Debug dump of the subtree, see `AstSerializer` to stream it instead
+    [[nodiscard]] std::string toString() const;
 };
 
 class AstRoot: AstNode {
@@ -35,17 +46,13 @@ public:
     ~AstRoot() override;
 
     void addNode(std::unique_ptr<AstNode> node);
-    RuntimeValue eval() override { return {}; };
-    std::string toString() override {
-        std::stringstream oss;
-        oss << "[\n";
-        for (const auto& anode: m_astNodes) {
-            oss << anode->toString();
-        }
-        oss << "\n]\n";
-
-        return oss.str();
-    }
+    [[nodiscard]] const std::pmr::vector<std::unique_ptr<AstNode> > &nodes() const { return m_astNodes; }
+    // Moves all top-level expressions out, leaving the root empty
+    std::pmr::vector<std::unique_ptr<AstNode> > takeNodes();
+    // Replaces the top-level expressions in `[first, last)` with `nodes`
+    void replaceNodes(std::size_t first, std::size_t last, std::pmr::vector<std::unique_ptr<AstNode> > nodes);
+    RuntimeValue eval(Interpreter &interp) override;
+    [[nodiscard]] std::string toString() const;
 
 private:
     std::pmr::vector<std::unique_ptr<AstNode> > m_astNodes;
@@ -54,15 +61,10 @@ private:
 struct UnaryExpr : AstNode {
     UnaryExpr(std::unique_ptr<AstNode> expr, std::string op);
     ~UnaryExpr() override;
-    RuntimeValue eval() override;
-    std::string toString() override {
-        std::stringstream oss;
-        oss << "{ type: " << name;
-        oss << ", op: " << m_op;
-        oss << ", right: " << m_expr->toString();
-        oss << " }";
-        return oss.str();
-    }
+    RuntimeValue eval(Interpreter &interp) override;
+
+    [[nodiscard]] const std::string &op() const { return m_op; }
+    [[nodiscard]] AstNode &expr() const { return *m_expr; }
 
 private:
     std::string m_op;
@@ -72,46 +74,133 @@ private:
 struct BinaryExpr : AstNode {
     BinaryExpr(std::unique_ptr<AstNode> left, std::string op, std::unique_ptr<AstNode> right);
     ~BinaryExpr() override;
-    RuntimeValue eval() override;
-    std::string toString() override {
-        std::stringstream oss;
-        oss << "\n{ ";
-        oss << "\n\ttype: " << name;
-        oss << ", \n\tleft: " << m_left->toString();
-        oss << ", \n\top: " << m_op;
-        oss << ", \n\tright: " << m_right->toString();
-        oss << " \n}\n";
-        return oss.str();
+    RuntimeValue eval(Interpreter &interp) override;
+
+    [[nodiscard]] const std::string &op() const { return m_op; }
+    [[nodiscard]] AstNode &left() const { return *m_left; }
+    [[nodiscard]] AstNode &right() const { return *m_right; }
+
+    // Replaces the generic operator with one specialized for operands both of type
+    // `operands`. Operands of any other type at runtime still take the generic one.
+    void setFastOp(const BinaryOpFn fn, const ValueType operands) {
+        m_fastOp = fn;
+        m_fastOperands = operands;
     }
 
 private:
     std::string m_op;
     std::unique_ptr<AstNode> m_left, m_right;
+    BinaryOpFn m_fastOp = nullptr;
+    ValueType m_fastOperands = ValueType::ANY;
+};
+
+// Dotted member access chain such as `auth.user.id`, collapsed into a single node
+struct MemberExpr : AstNode {
+    MemberExpr(std::unique_ptr<AstNode> object, std::vector<std::string> path);
+    ~MemberExpr() override;
+    RuntimeValue eval(Interpreter &interp) override;
+
+    [[nodiscard]] AstNode &object() const { return *m_object; }
+    [[nodiscard]] std::vector<std::string> path() const;
+    // Same as `path()[i]` without copying the path
+    [[nodiscard]] std::size_t pathLength() const { return m_path.size(); }
+    [[nodiscard]] const std::string &field(const std::size_t i) const { return m_path[i].field; }
+
+    // Walks the path on an already evaluated object; `nil` anywhere along the
+    // path, or a field missing from the object's shape, yields `nil`.
+    [[nodiscard]] RuntimeValue access(const RuntimeValue &object) const;
+
+    // Resolves the path against the shape the object is known to have, priming
+    // every inline cache. Returns the type of the accessed field, throws
+    // `std::runtime_error` if the path names a field missing from a known shape.
+    ValueType bindShape(const Shape &shape) const;
+
+private:
+    // Monomorphic inline cache: the field index is valid for objects of the shape
+    // cached with it. Both are packed in one atomic word, so that threads evaluating
+    // the same program at once never pair one shape with another shape's index.
+    struct PathStep {
+        explicit PathStep(std::string field) : field(std::move(field)) {
+        }
+
+        PathStep(const PathStep &other)
+            : field(other.field),
+              cache(other.cache.load(std::memory_order_relaxed)) {
+        }
+
+        PathStep &operator=(const PathStep &) = delete;
+
+        static uint64_t pack(const uint32_t shapeId, const uint32_t index) {
+            return static_cast<uint64_t>(shapeId) << 32 | index;
+        }
+
+        std::string field;
+        mutable std::atomic<uint64_t> cache{0}; // Shape id 0 is never handed out
+    };
+
+    std::unique_ptr<AstNode> m_object;
+    std::vector<PathStep> m_path;
+};
+
+// Builtin call, `x.f(y)` method calls are desugared into `f(x, y)`
+struct CallExpr : AstNode {
+    // Resolves `fn` against the builtin registry, throws `std::runtime_error` for
+    // unknown builtins or a wrong number of arguments
+    CallExpr(const std::string &fn, std::vector<std::unique_ptr<AstNode> > args);
+    ~CallExpr() override;
+    RuntimeValue eval(Interpreter &interp) override;
+
+    [[nodiscard]] int builtin() const { return m_builtin; }
+    [[nodiscard]] const std::vector<std::unique_ptr<AstNode> > &args() const { return m_args; }
+
+private:
+    int m_builtin;
+    std::vector<std::unique_ptr<AstNode> > m_args;
+};
+
+// `subject ~= pattern`, literal patterns are compiled once when the node is built
+// (throwing `std::runtime_error` if malformed), others on first use through the
+// shared `PatternCache`.
+struct MatchExpr : AstNode {
+    MatchExpr(std::unique_ptr<AstNode> subject, std::unique_ptr<AstNode> pattern);
+    ~MatchExpr() override;
+    RuntimeValue eval(Interpreter &interp) override;
+
+    [[nodiscard]] AstNode &subject() const { return *m_subject; }
+    [[nodiscard]] AstNode &pattern() const { return *m_pattern; }
+
+    // Matches already evaluated operands, reusing `scratch` for NFA patterns if given
+    [[nodiscard]] RuntimeValue match(const RuntimeValue &subject, const RuntimeValue &pattern,
+                                     Pattern::Scratch *scratch = nullptr) const;
+
+private:
+    std::unique_ptr<AstNode> m_subject, m_pattern;
+    std::shared_ptr<const Pattern> m_compiled;
 };
 
 struct IdentifierExpr : AstNode {
     explicit IdentifierExpr(std::string ident);
     ~IdentifierExpr() override;
-    RuntimeValue eval() override;
-    std::string toString() override {
-        std::stringstream oss;
-        oss << "{ type: " << name << ", name: " << m_ident << " }";
-        return oss.str();
-    }
+    RuntimeValue eval(Interpreter &interp) override;
+
+    [[nodiscard]] const std::string &ident() const { return m_ident; }
+
+    // Reads the identifier from slot `slot` of the interpreter's host object instead
+    // of looking it up by name, when the interpreter has one
+    void bindSlot(const int32_t slot) { m_slot = slot; }
+    [[nodiscard]] int32_t slot() const { return m_slot; }
 
 private:
     std::string m_ident;
+    int32_t m_slot = -1;
 };
 
 struct BooleanLiteral : AstNode {
     explicit BooleanLiteral(bool status);
     ~BooleanLiteral() override;
-    RuntimeValue eval() override;
-    std::string toString() override {
-        std::stringstream oss;
-        oss << "{ type: " << name << ", value: " << (m_bool ? "true" : "false") << " }";
-        return oss.str();
-    }
+    RuntimeValue eval(Interpreter &interp) override;
+
+    [[nodiscard]] bool value() const { return m_bool; }
 
 private:
     bool m_bool = false;
@@ -119,41 +208,31 @@ private:
 
 struct NumberLiteral : AstNode {
     explicit NumberLiteral(double val);
+    explicit NumberLiteral(int64_t val);
     ~NumberLiteral() override;
-    RuntimeValue eval() override;
-    std::string toString() override {
-        std::stringstream oss;
-        oss << "{ type: " << name << ", value: " << m_val << " }";
-        return oss.str();
-    }
+    RuntimeValue eval(Interpreter &interp) override;
+
+    [[nodiscard]] const RuntimeValue &value() const { return m_val; }
 
 private:
-    double m_val = 0.0;
+    RuntimeValue m_val; // Integral literals are kept as exact integers
 };
 
 struct NullLiteral : AstNode {
     explicit NullLiteral();
     ~NullLiteral() override;
-    RuntimeValue eval() override;
-    std::string toString() override {
-        std::stringstream oss;
-        oss << "{ type: " << name << " }";
-        return oss.str();
-    }
+    RuntimeValue eval(Interpreter &interp) override;
 };
 
 struct StringLiteral : AstNode {
     explicit StringLiteral(std::string val);
     ~StringLiteral() override;
-    RuntimeValue eval() override;
-    std::string toString() override {
-        std::stringstream oss;
-        oss << "{ type: " << name << ", value: " << m_val << " }";
-        return oss.str();
-    }
+    RuntimeValue eval(Interpreter &interp) override;
+
+    [[nodiscard]] const std::string &value() const { return m_val.str(); }
 
 private:
-    std::string m_val;
+    StringValue m_val; // Pinned while the literal lives, evaluating it never copies the text
 };
 
 
@@ -0,0 +1,47 @@
+#ifndef MBS_INCREMENTAL_H
+#define MBS_INCREMENTAL_H
+
+#include <string>
+#include <vector>
+
+#include "ast.h"
+#include "token.h"
+
+namespace mbs {
+    // Keeps a multi-expression document parsed across edits. An edit only re-lexes
+    // and re-parses the top-level expressions around it, growing the window until
+    // the new parse lines up with an unchanged expression boundary again; every
+    // other top-level expression keeps its existing subtree.
+    class IncrementalParser {
+    public:
+        // Parses `text` from scratch, throwing on lex or parse errors
+        explicit IncrementalParser(std::string text);
+
+        // Replaces `removed` chars at `offset` with `inserted`. Throws on lex or parse
+        // errors, in which case the text is still updated but the AST isn't, and the
+        // next edit re-parses the whole document.
+        void edit(std::size_t offset, std::size_t removed, const std::string &inserted);
+
+        [[nodiscard]] const std::string &text() const { return m_text; }
+        AstRoot &root() { return m_root; }
+        // Source span of each top-level expression, parallel to `root().nodes()`
+        [[nodiscard]] const std::vector<Token::Position> &spans() const { return m_spans; }
+
+        // Top-level expressions parsed by the last edit, the rest were reused
+        [[nodiscard]] std::size_t reparsed() const { return m_reparsed; }
+
+    private:
+        void parseAll();
+        // Re-parses `[m_text + start, stop)` in place of the expressions `[first, last)`,
+        // returning false when the result doesn't end on the boundary at `stop`
+        bool reparse(std::size_t first, std::size_t last, int start, int stop, int line);
+
+        std::string m_text;
+        AstRoot m_root;
+        std::vector<Token::Position> m_spans;
+        std::size_t m_reparsed = 0;
+        bool m_stale = false;
+    };
+}
+
+#endif //MBS_INCREMENTAL_H
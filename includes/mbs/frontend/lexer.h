@@ -3,6 +3,7 @@
 
 #include <format>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "token.h"
@@ -11,6 +12,10 @@ namespace mbs {
     struct Lexer {
         std::vector<Token> tokens;
         const std::vector<Token> &lex(const std::string &source);
+        // Lexes `source` from offset `begin`, which lies on line `line`, with positions
+        // relative to the whole source. No token is started at or past `stop`, though
+        // the last token may run past it; the EOF token marks where lexing ended.
+        const std::vector<Token> &lex(std::string_view source, int begin, int stop, int line);
 
     private:
         void lexNumericals();
@@ -29,7 +34,8 @@ namespace mbs {
         void expect(char c, const std::string &err);
 
         int m_current = 0, m_line = 1, m_index = 0;
-        std::string m_src; // Source string to lex
+        int m_stop = 0;
+        std::string_view m_src; // Source string to lex, only valid during `lex`
     };
 };
 
@@ -0,0 +1,50 @@
+#ifndef MBS_PARALLEL_PARSER_H
+#define MBS_PARALLEL_PARSER_H
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ast.h"
+#include "token.h"
+
+namespace mbs {
+    // Where `input` may be cut into independently parsable chunks: offsets of the
+    // first token after a newline that is outside strings and parentheses, follows
+    // a token that can end an expression and precedes one that can't continue it.
+    // At most `chunks - 1` cuts are made, spread evenly over the input.
+    struct Cut {
+        int offset;
+        int line;
+    };
+
+    std::vector<Cut> findCuts(const std::string &input, std::size_t chunks);
+
+    // Parses large multi-expression scripts by lexing and parsing chunks of the
+    // input on worker threads, then stitching them back in order. Produces the same
+    // AST and positions as `Parser`; on errors, the one of the earliest failing chunk
+    // is thrown and the root is left empty.
+    class ParallelParser {
+    public:
+        // Inputs below this size are parsed on the calling thread
+        static constexpr std::size_t MIN_CHUNK_SIZE = 16 * 1024;
+
+        explicit ParallelParser(unsigned threads = std::thread::hardware_concurrency());
+
+        void parse(const std::string &input);
+
+        AstRoot &root() { return m_root; }
+        // Source span of each top-level expression, parallel to `root().nodes()`
+        [[nodiscard]] const std::vector<Token::Position> &spans() const { return m_spans; }
+        // Chunks the last input was split into
+        [[nodiscard]] std::size_t chunks() const { return m_chunks; }
+
+    private:
+        unsigned m_threads;
+        AstRoot m_root;
+        std::vector<Token::Position> m_spans;
+        std::size_t m_chunks = 0;
+    };
+}
+
+#endif //MBS_PARALLEL_PARSER_H
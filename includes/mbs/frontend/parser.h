@@ -1,9 +1,11 @@
 #ifndef MBS_PARSER_H
 #define MBS_PARSER_H
 
+#include <charconv>
 #include <iostream>
 #include <string>
 #include "ast.h"
+#include "../backend/profiler.h"
 #include "lexer.h"
 #include "token.h"
 
@@ -13,24 +15,55 @@ namespace mbs {
         Parser() = default;
 
         void parse(const std::string &input) {
-            m_tokens = lexer.lex(input);
-            while (!isEOF()) {
-                m_root.addNode(parseExpr());
+            {
+                MBS_PROFILE_PHASE(Profiler::Phase::LEX);
+                m_tokens = lexer.lex(input);
             }
+
+            parseTokens();
+        }
+
+        // Parses an already lexed token stream ending with an EOF token
+        void parse(std::vector<Token> tokens) {
+            m_tokens = std::move(tokens);
+            m_current = 0;
+            parseTokens();
         }
 
         std::string toString() {
             return m_root.toString();
         }
 
+        AstRoot &root() {
+            return m_root;
+        }
+
+        // Source span of each top-level expression, parallel to `root().nodes()`
+        [[nodiscard]] const std::vector<Token::Position> &spans() const {
+            return m_spans;
+        }
+
     private:
+        void parseTokens() {
+            MBS_PROFILE_PHASE(Profiler::Phase::PARSE);
+            while (!isEOF()) {
+                const auto first = peek().pos;
+                m_root.addNode(parseExpr());
+                m_spans.push_back(Token::Position{
+                    .start = first.start,
+                    .end = m_tokens[m_current - 1].pos.end,
+                    .line = first.line
+                });
+            }
+        }
+
         std::unique_ptr<AstNode> parseExpr() {
             return parseOr();
         }
 
         std::unique_ptr<AstNode> parseOr() {
             auto left = parseAnd();
-            while (!isEOF() && (peek().type == TokenType::TOK_OR || peek().type == TokenType::TOK_AND)) {
+            while (!isEOF() && peek().type == TokenType::TOK_OR) {
                 auto op = advance().value;
                 auto right = parseAnd();
                 left = std::make_unique<BinaryExpr>(std::move(left), op, std::move(right));
@@ -40,7 +73,7 @@ namespace mbs {
 
         std::unique_ptr<AstNode> parseAnd() {
             auto left = parseEquality();
-            while (!isEOF() && (peek().type == TokenType::TOK_OR || peek().type == TokenType::TOK_AND)) {
+            while (!isEOF() && peek().type == TokenType::TOK_AND) {
                 auto op = advance().value;
                 auto right = parseEquality();
                 left = std::make_unique<BinaryExpr>(std::move(left), op, std::move(right));
@@ -50,10 +83,20 @@ namespace mbs {
 
         std::unique_ptr<AstNode> parseEquality() {
             auto left = parseRelational();
-            while (!isEOF() && (peek().type == TokenType::TOK_EQUALS || peek().type == TokenType::TOK_NOT_EQUALS)) {
-                auto op = advance().value;
+            while (!isEOF()
+                   && (
+                       peek().type == TokenType::TOK_EQUALS
+                       || peek().type == TokenType::TOK_NOT_EQUALS
+                       || peek().type == TokenType::TOK_MATCH
+                   )
+            ) {
+                auto op = advance();
                 auto right = parseRelational();
-                left = std::make_unique<BinaryExpr>(std::move(left), op, std::move(right));
+                if (op.type == TokenType::TOK_MATCH) {
+                    left = std::make_unique<MatchExpr>(std::move(left), std::move(right));
+                } else {
+                    left = std::make_unique<BinaryExpr>(std::move(left), op.value, std::move(right));
+                }
             }
             return left;
         }
@@ -132,7 +175,57 @@ namespace mbs {
                 auto right = parseUnary(); // Right Associative
                 return std::make_unique<UnaryExpr>(std::move(right), op);
             }
-            return parsePrimary();
+            return parseMember();
+        }
+
+        std::unique_ptr<AstNode> parseMember() {
+            auto object = parsePrimary();
+
+            // Collapse each `a.b.c` run into a single node, `.f(...)` ends the run
+            std::vector<std::string> path;
+            while (!isEOF() && peek().type == TokenType::TOK_DOT) {
+                advance(); // Consume dot
+                if (isEOF() || peek().type != TokenType::TOK_IDENT) {
+                    throw std::runtime_error("Expected a field name after `.`");
+                }
+
+                auto field = advance().value;
+                if (isEOF() || peek().type != TokenType::TOK_OPEN_PAREN) {
+                    path.push_back(std::move(field));
+                    continue;
+                }
+
+                if (!path.empty()) {
+                    object = std::make_unique<MemberExpr>(std::move(object), std::move(path));
+                    path.clear();
+                }
+
+                // Method call, the receiver is passed as the first argument
+                std::vector<std::unique_ptr<AstNode> > args;
+                args.push_back(std::move(object));
+                parseArgs(args);
+                object = std::make_unique<CallExpr>(field, std::move(args));
+            }
+
+            if (path.empty()) return object;
+            return std::make_unique<MemberExpr>(std::move(object), std::move(path));
+        }
+
+        void parseArgs(std::vector<std::unique_ptr<AstNode> > &args) {
+            const auto open_paren = advance(); // Consume open paren
+            if (!isEOF() && peek().type != TokenType::TOK_CLOSE_PAREN) {
+                args.push_back(parseExpr());
+                while (!isEOF() && peek().type == TokenType::TOK_COMMA) {
+                    advance(); // Consume comma
+                    args.push_back(parseExpr());
+                }
+            }
+
+            expect(TokenType::TOK_CLOSE_PAREN,
+                   std::format("Expected `)` closing the call arguments opened on line {}",
+                               open_paren.pos.line
+                   )
+            );
         }
 
         std::unique_ptr<AstNode> parsePrimary() {
@@ -171,7 +264,15 @@ namespace mbs {
 
         std::unique_ptr<AstNode> parseNumber() {
             try {
-                double num = std::stof(advance().value);
+                const auto &text = advance().value;
+                if (text.find('.') == std::string::npos) {
+                    int64_t num = 0;
+                    const auto [_, ec] = std::from_chars(text.data(), text.data() + text.size(), num);
+                    if (ec == std::errc{}) return std::make_unique<NumberLiteral>(num);
+                    // Out of int64 range, fall back to a double
+                }
+
+                double num = std::stod(text);
                 return std::make_unique<NumberLiteral>(num);
             } catch (const std::exception &e) {
                 std::cerr << "Parser Error: " << e.what() << std::endl;
@@ -184,7 +285,14 @@ namespace mbs {
         }
 
         std::unique_ptr<AstNode> parseIdent() {
-            return std::make_unique<IdentifierExpr>(advance().value);
+            auto ident = advance().value;
+            if (isEOF() || peek().type != TokenType::TOK_OPEN_PAREN) {
+                return std::make_unique<IdentifierExpr>(ident);
+            }
+
+            std::vector<std::unique_ptr<AstNode> > args;
+            parseArgs(args);
+            return std::make_unique<CallExpr>(ident, std::move(args));
         }
 
         std::unique_ptr<AstNode> parseBool() {
@@ -192,7 +300,7 @@ namespace mbs {
         }
 
         bool isEOF() {
-            return m_tokens.empty() || peek().type == TokenType::TOK_EOF || m_current >= m_tokens.size();
+            return static_cast<std::size_t>(m_current) >= m_tokens.size() || peek().type == TokenType::TOK_EOF;
         }
 
         const Token &peek() {
@@ -212,6 +320,7 @@ namespace mbs {
         }
 
         AstRoot m_root;
+        std::vector<Token::Position> m_spans;
         std::vector<Token> m_tokens;
 
         Lexer lexer;
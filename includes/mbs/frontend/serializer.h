@@ -0,0 +1,68 @@
+#ifndef MBSCRIPT_SERIALIZER_H
+#define MBSCRIPT_SERIALIZER_H
+
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "ast.h"
+#include "token.h"
+
+// Writes ASTs and token streams straight into `out` in a single pass. Each node
+// visited writes its own fields and schedules its children in place, instead of
+// returning a string for its parent to copy. The tree is walked with an explicit
+// stack, so however deep it is, serializing never overflows the call stack.
+class AstSerializer {
+public:
+    enum class Format : uint8_t {
+        DEBUG, // Same text as `AstNode::toString`
+        JSON,
+    };
+
+    AstSerializer(std::ostream &out, Format format);
+
+    void write(const AstRoot &root);
+    void write(const AstNode &node);
+    // Lexer output, the debug format being the one of `Token::operator<<`
+    void write(std::span<const mbs::Token> tokens);
+
+private:
+    // Pending output: a node to visit, or text to write as is (or as a JSON string)
+    struct Item {
+        const AstNode *node = nullptr;
+        std::string_view text;
+        bool quoted = false;
+    };
+
+    void drain();
+    void visit(const AstNode &node);
+
+    void visit(const UnaryExpr &node);
+    void visit(const BinaryExpr &node);
+    void visit(const MemberExpr &node);
+    void visit(const CallExpr &node);
+    void visit(const MatchExpr &node);
+    void visit(const IdentifierExpr &node);
+    void visit(const BooleanLiteral &node);
+    void visit(const NumberLiteral &node);
+    void visit(const NullLiteral &node);
+    void visit(const StringLiteral &node);
+
+    // Schedule output after the node being visited, in call order
+    void then(std::string_view text);
+    void then(const AstNode &node);
+    void thenString(std::string_view text);
+
+    void writeString(std::string_view text);
+    void writeType(const AstNode &node);
+
+    std::ostream &m_out;
+    Format m_format;
+
+    std::vector<Item> m_pending; // Top is written next
+    std::size_t m_scheduled = 0; // Start of the items scheduled by the current visit
+};
+
+#endif //MBSCRIPT_SERIALIZER_H
@@ -46,6 +46,7 @@ namespace mbs {
         TOK_GREATER, // a > b
         TOK_LESS_OR_EQUALS, // a <= b
         TOK_GREATER_OR_EQUALS, // a >= b
+        TOK_MATCH, // a ~= 'pattern'
         TOK_AND, //  a && b
         TOK_OR, // a || b
 
@@ -67,12 +68,12 @@ namespace mbs {
         TokenType type = TokenType::TOK_INVALID; // Token type
 
         friend std::ostream &operator<<(std::ostream &os, const Token &m) {
-            os << std::string{"{"} << std::endl;
-            os << std::string{"\tvalue: "} << m.value << "," << std::endl;
-            os << std::string{"\tpos: { start: "} << m.pos.start << ", end: " << m.pos.end << ", line: " << m.pos.line
-                    << " }," << std::endl;
-            os << std::string{"\ttype: "} << std::format("{}", tokenTypeToString(m.type)) << std::endl;
-            os << std::string{"}"} << std::endl;
+            // Plain newlines, dumping many tokens shouldn't flush after every line
+            os << "{\n";
+            os << "\tvalue: " << m.value << ",\n";
+            os << "\tpos: { start: " << m.pos.start << ", end: " << m.pos.end << ", line: " << m.pos.line << " },\n";
+            os << "\ttype: " << tokenTypeToString(m.type) << "\n";
+            os << "}\n";
             return os;
         }
     };
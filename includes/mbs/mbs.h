@@ -0,0 +1,91 @@
+#ifndef MBSCRIPT_MBS_H
+#define MBSCRIPT_MBS_H
+
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "bindings.h"
+#include "backend/interpreter.h"
+#include "backend/runtime.h"
+
+class AstRoot;
+
+// Stable embedding API of libmbs: compile a script once, evaluate it many times
+namespace mbs {
+    // Thrown by `compile` when the script type checks with errors
+    class CompileError : public std::runtime_error {
+    public:
+        explicit CompileError(std::vector<std::string> errors);
+
+        [[nodiscard]] const std::vector<std::string> &errors() const { return m_errors; }
+
+    private:
+        std::vector<std::string> m_errors;
+    };
+
+    class Program {
+    public:
+        using Bindings = Interpreter::Bindings;
+
+        // Parses and type checks `source`. With a `schema`, every identifier must name
+        // one of its fields and is bound to that field's slot. Throws `CompileError`
+        // on type errors, `std::runtime_error` on syntax errors.
+        static Program compile(const std::string &source, const std::vector<HostField> &schema = {});
+
+        Program(Program &&other) noexcept;
+        Program &operator=(Program &&other) noexcept;
+        ~Program();
+
+        // Evaluates every top-level expression, returning the last result. Bindings are
+        // not checked against the schema, a missing or mistyped one evaluates the same
+        // as in a program compiled without a schema.
+        RuntimeValue evaluate(const Bindings &bindings = {});
+        BudgetedResult evaluate(const Bindings &bindings, const EvalBudget &budget);
+        // Evaluates against a host object, identifiers reading the fields of `schema`
+        // passed to `compile` through `readers`, in the same order
+        RuntimeValue evaluate(const void *host, const Interpreter::SlotReader *readers);
+        // Allocation-free variants writing every top-level result into `scratch`, which
+        // may refer to the program's string literals and must not outlive it
+        std::span<const RuntimeValue> evaluate(const Bindings &bindings, EvalScratch &scratch);
+        std::span<const RuntimeValue> evaluate(const void *host, const Interpreter::SlotReader *readers,
+                                               EvalScratch &scratch);
+        BudgetedResult evaluate(const Bindings &bindings, const EvalBudget &budget, EvalScratch &scratch);
+
+        [[nodiscard]] std::string toString() const;
+
+    private:
+        explicit Program(std::unique_ptr<AstRoot> root);
+
+        std::unique_ptr<AstRoot> m_root;
+    };
+
+    // Program whose identifiers are fields of the host struct `T`, see `Fields`. Names
+    // are resolved to fields at compile time, so reading one is a direct member load.
+    template<typename T>
+    class TypedProgram {
+    public:
+        // Throws `CompileError` when `source` reads an identifier `T` has no field for
+        static TypedProgram compile(const std::string &source) {
+            return TypedProgram(Program::compile(source, HostLayout<T>::fields()));
+        }
+
+        RuntimeValue evaluate(const T &host) {
+            return m_program.evaluate(&host, HostLayout<T>::readers.data());
+        }
+
+        std::span<const RuntimeValue> evaluate(const T &host, EvalScratch &scratch) {
+            return m_program.evaluate(&host, HostLayout<T>::readers.data(), scratch);
+        }
+
+    private:
+        explicit TypedProgram(Program program) : m_program(std::move(program)) {
+        }
+
+        Program m_program;
+    };
+}
+
+#endif //MBSCRIPT_MBS_H
@@ -0,0 +1,132 @@
+#ifndef MBSCRIPT_SERVER_H
+#define MBSCRIPT_SERVER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <istream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "mbs.h"
+
+// Long-running evaluation server speaking a length-prefixed binary protocol, so
+// that other processes can compile scripts once and evaluate them many times.
+//
+// Every integer is little-endian. A frame is a `u32` payload length followed by
+// the payload; requests are `u32 id, u8 op, body` and responses `u32 id, u8 status,
+// body`, where an `ERROR` body is a single string. Strings are a `u32` length and
+// the bytes, values a `u8` tag followed by nothing (`NIL`), a `u8` (`BOOL`), an
+// `i64` (`INT`), an `f64` (`DOUBLE`) or a string (`STRING`).
+//
+//   COMPILE   source: string                  -> handle: u64
+//   EVALUATE  handle: u64, names: u32 count + strings,
+//             rows: u32 count + one value per name each
+//                                             -> u32 count + per row `u8 status`
+//                                                and a value or an error string
+//   RELEASE   handle: u64                     -> (empty)
+//
+// Requests are handled concurrently, so responses may come back in any order and
+// are matched to requests by id.
+//
+// An EVALUATE request shares one budget between its rows: `MAX_EVALUATE_STEPS`
+// steps, every row counting at least one, and `EVALUATE_TIMEOUT`. Exceeding either
+// fails the whole request, as does a response growing past `MAX_FRAME_SIZE`; a row
+// building more than `MAX_ROW_MEMORY` bytes of strings only fails that row.
+namespace mbs {
+    namespace wire {
+        enum class Op : uint8_t {
+            COMPILE = 1,
+            EVALUATE = 2,
+            RELEASE = 3,
+        };
+
+        enum class Status : uint8_t {
+            OK,
+            ERROR,
+        };
+
+        enum class Tag : uint8_t {
+            NIL,
+            BOOL,
+            INT,
+            DOUBLE,
+            STRING,
+        };
+    }
+
+    // Bounded LRU cache of compiled programs, shared by every client. Compiling a
+    // source that is already cached returns its existing handle without recompiling.
+    class ProgramCache {
+    public:
+        explicit ProgramCache(std::size_t capacity);
+
+        // Throws `CompileError` or `std::runtime_error` when `source` doesn't compile
+        uint64_t compile(const std::string &source);
+        // `nullptr` once the handle was released or evicted
+        [[nodiscard]] std::shared_ptr<Program> find(uint64_t handle);
+        void release(uint64_t handle);
+
+        [[nodiscard]] std::size_t size() const;
+
+    private:
+        struct Entry {
+            uint64_t handle;
+            std::string source;
+            std::shared_ptr<Program> program;
+        };
+
+        void evict(std::list<Entry>::iterator it);
+
+        mutable std::mutex m_mutex;
+        std::size_t m_capacity;
+        uint64_t m_nextHandle = 1;
+        std::list<Entry> m_lru; // Most recently used first
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> m_bySource;
+        std::unordered_map<uint64_t, std::list<Entry>::iterator> m_byHandle;
+    };
+
+    class Server {
+    public:
+        static constexpr std::size_t DEFAULT_CACHE_CAPACITY = 1024;
+        // Largest frame accepted, larger ones end the session
+        static constexpr uint32_t MAX_FRAME_SIZE = 64 * 1024 * 1024;
+        static constexpr uint64_t MAX_EVALUATE_STEPS = 16 * 1024 * 1024;
+        static constexpr std::size_t MAX_ROW_MEMORY = 16 * 1024 * 1024;
+        static constexpr std::chrono::seconds EVALUATE_TIMEOUT{10};
+
+        explicit Server(unsigned threads = std::thread::hardware_concurrency(),
+                        std::size_t cacheCapacity = DEFAULT_CACHE_CAPACITY);
+        Server(const Server &) = delete;
+        Server &operator=(const Server &) = delete;
+
+        // Answers requests read from `in` on `out` until `in` ends, then waits for
+        // the requests still in flight
+        void serve(std::istream &in, std::ostream &out);
+
+        // Handles one request payload, returning the response payload
+        std::string handle(std::string_view request);
+
+    private:
+        void work(std::ostream &out, EvalScratch &scratch);
+        std::string handle(std::string_view request, EvalScratch &scratch);
+
+        unsigned m_threads;
+        ProgramCache m_cache;
+
+        std::mutex m_mutex;
+        std::condition_variable m_ready, m_space;
+        std::deque<std::string> m_queue;
+        bool m_closing = false;
+
+        std::mutex m_outMutex;
+    };
+}
+
+#endif //MBSCRIPT_SERVER_H
@@ -0,0 +1,295 @@
+#include "../../includes/mbs/backend/async_eval.h"
+
+#include <array>
+#include <exception>
+#include <thread>
+
+#include "../../includes/mbs/frontend/ast.h"
+
+// ------------ RESOLVERS -------------------- //
+Resolver::~Resolver() = default;
+
+InMemoryResolver::InMemoryResolver(Interpreter::Bindings records, const std::chrono::microseconds latency)
+    : m_records(std::move(records)),
+      m_latency(latency) {
+}
+
+void InMemoryResolver::resolve(const std::span<const std::string> keys, const std::span<RuntimeValue> out) {
+    if (m_latency.count() > 0) std::this_thread::sleep_for(m_latency);
+
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        const auto it = m_records.find(keys[i]);
+        out[i] = it == m_records.end() ? RuntimeValue{} : it->second;
+    }
+    m_calls++;
+    m_keys += keys.size();
+}
+
+// ------------ COROUTINES -------------------- //
+// Lazily started coroutine producing a value; awaiting it starts the child and
+// transfers straight back to the awaiting parent once the child completes.
+struct AsyncEvaluator::Task {
+    struct promise_type {
+        RuntimeValue value;
+        std::exception_ptr error;
+        std::coroutine_handle<> continuation;
+
+        Task get_return_object() {
+            return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        auto final_suspend() noexcept {
+            struct Final {
+                bool await_ready() noexcept { return false; }
+
+                std::coroutine_handle<> await_suspend(const std::coroutine_handle<promise_type> self) noexcept {
+                    const auto next = self.promise().continuation;
+                    return next ? next : std::noop_coroutine();
+                }
+
+                void await_resume() noexcept {
+                }
+            };
+            return Final{};
+        }
+
+        void return_value(RuntimeValue val) { value = std::move(val); }
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    explicit Task(const std::coroutine_handle<promise_type> handle) : handle(handle) {
+    }
+
+    Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    ~Task() {
+        if (handle) handle.destroy();
+    }
+
+    bool await_ready() { return false; }
+
+    std::coroutine_handle<> await_suspend(const std::coroutine_handle<> parent) {
+        handle.promise().continuation = parent;
+        return handle;
+    }
+
+    RuntimeValue await_resume() {
+        auto &promise = handle.promise();
+        if (promise.error) std::rethrow_exception(promise.error);
+        return std::move(promise.value);
+    }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Suspends until the next batch resolves `ident`, unless this run already has
+class AsyncEvaluator::Lookup {
+public:
+    Lookup(AsyncEvaluator &evaluator, const std::string &ident) : m_evaluator(evaluator), m_ident(ident) {
+    }
+
+    bool await_ready() {
+        const auto it = m_evaluator.m_resolved.find(m_ident);
+        if (it == m_evaluator.m_resolved.end()) return false;
+        m_value = it->second;
+        return true;
+    }
+
+    void await_suspend(const std::coroutine_handle<> handle) {
+        m_evaluator.m_pending[m_ident].push_back(Waiter{handle, &m_value});
+    }
+
+    RuntimeValue await_resume() { return std::move(m_value); }
+
+private:
+    AsyncEvaluator &m_evaluator;
+    const std::string &m_ident;
+    RuntimeValue m_value;
+};
+
+struct AsyncEvaluator::Evaluation {
+    AstRoot &program;
+    std::optional<Task> task;
+};
+
+// ------------ ASYNC EVALUATOR -------------------- //
+AsyncEvaluator::AsyncEvaluator(Resolver &resolver, const Interpreter::Bindings &local)
+    : m_resolver(resolver),
+      m_local(local) {
+}
+
+AsyncEvaluator::~AsyncEvaluator() = default;
+
+std::size_t AsyncEvaluator::submit(AstRoot &program) {
+    m_evaluations.push_back(std::make_unique<Evaluation>(Evaluation{.program = program, .task = std::nullopt}));
+    return m_evaluations.size() - 1;
+}
+
+std::vector<AsyncEvaluator::Result> AsyncEvaluator::run() {
+    try {
+        for (const auto &evaluation: m_evaluations) {
+            evaluation->task.emplace(evalProgram(evaluation->program));
+            m_ready.push_back(evaluation->task->handle);
+        }
+
+        while (true) {
+            // Run everything runnable until it either finishes or waits on a lookup
+            while (!m_ready.empty()) {
+                const auto handle = m_ready.back();
+                m_ready.pop_back();
+                handle.resume();
+            }
+
+            if (m_pending.empty()) break;
+            resolvePending();
+        }
+    } catch (...) {
+        reset();
+        throw;
+    }
+
+    std::vector<Result> results(m_evaluations.size());
+    for (std::size_t i = 0; i < m_evaluations.size(); ++i) {
+        auto &promise = m_evaluations[i]->task->handle.promise();
+        if (!promise.error) {
+            // Programs may be gone by the time results are read
+            results[i].value = promise.value.detached();
+            continue;
+        }
+
+        try {
+            std::rethrow_exception(promise.error);
+        } catch (const std::exception &e) {
+            results[i].error = e.what();
+        } catch (...) {
+            results[i].error = "Unknown evaluation error";
+        }
+    }
+
+    reset();
+    return results;
+}
+
+void AsyncEvaluator::resolvePending() {
+    std::vector<std::string> keys;
+    keys.reserve(m_pending.size());
+    for (const auto &[key, _]: m_pending) keys.push_back(key);
+
+    std::vector<RuntimeValue> values(keys.size());
+    m_resolver.resolve(keys, values);
+    m_batches++;
+
+    auto pending = std::move(m_pending);
+    m_pending.clear();
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        for (const auto &[handle, slot]: pending[keys[i]]) {
+            *slot = values[i];
+            m_ready.push_back(handle);
+        }
+        m_resolved.insert_or_assign(std::move(keys[i]), std::move(values[i]));
+    }
+}
+
+void AsyncEvaluator::reset() {
+    // Destroying a root task destroys the child frames suspended beneath it
+    m_evaluations.clear();
+    m_ready.clear();
+    m_pending.clear();
+    m_resolved.clear();
+    m_remote.clear();
+}
+
+AsyncEvaluator::Task AsyncEvaluator::evalProgram(AstRoot &program) {
+    RuntimeValue result;
+    for (const auto &node: program.nodes()) {
+        result = co_await evalNode(*node);
+    }
+    co_return result;
+}
+
+AsyncEvaluator::Task AsyncEvaluator::evalNode(AstNode &node) {
+    if (!isRemote(node)) co_return node.eval(m_local);
+
+    switch (node.type) {
+        case NodeType::IDENTIFIER:
+            co_return co_await Lookup(*this, static_cast<IdentifierExpr &>(node).ident());
+        case NodeType::UNARY_EXPR: {
+            const auto &unary = static_cast<UnaryExpr &>(node);
+            co_return applyUnaryOp(unary.op(), co_await evalNode(unary.expr()));
+        }
+        case NodeType::BINARY_EXPR: {
+            const auto &binary = static_cast<BinaryExpr &>(node);
+            if (binary.op() == "&&") {
+                if (!(co_await evalNode(binary.left())).isTruthy()) co_return false;
+                co_return (co_await evalNode(binary.right())).isTruthy();
+            }
+            if (binary.op() == "||") {
+                if ((co_await evalNode(binary.left())).isTruthy()) co_return true;
+                co_return (co_await evalNode(binary.right())).isTruthy();
+            }
+
+            const auto lhs = co_await evalNode(binary.left());
+            co_return applyBinaryOp(binary.op(), lhs, co_await evalNode(binary.right()));
+        }
+        case NodeType::MEMBER_EXPR: {
+            const auto &member = static_cast<MemberExpr &>(node);
+            co_return member.access(co_await evalNode(member.object()));
+        }
+        case NodeType::CALL_EXPR: {
+            const auto &call = static_cast<CallExpr &>(node);
+            std::array<RuntimeValue, builtins::MAX_ARGS> args;
+            for (std::size_t i = 0; i < call.args().size(); ++i) {
+                args[i] = co_await evalNode(*call.args()[i]);
+            }
+            co_return builtins::at(call.builtin()).fn({args.data(), call.args().size()});
+        }
+        case NodeType::MATCH_EXPR: {
+            const auto &match = static_cast<MatchExpr &>(node);
+            const auto subject = co_await evalNode(match.subject());
+            co_return match.match(subject, co_await evalNode(match.pattern()));
+        }
+        default:
+            co_return node.eval(m_local);
+    }
+}
+
+bool AsyncEvaluator::isRemote(AstNode &node) {
+    if (const auto it = m_remote.find(&node); it != m_remote.end()) return it->second;
+
+    bool remote = false;
+    switch (node.type) {
+        case NodeType::IDENTIFIER:
+            remote = !m_local.find(static_cast<IdentifierExpr &>(node).ident());
+            break;
+        case NodeType::UNARY_EXPR:
+            remote = isRemote(static_cast<UnaryExpr &>(node).expr());
+            break;
+        case NodeType::BINARY_EXPR: {
+            const auto &binary = static_cast<BinaryExpr &>(node);
+            remote = isRemote(binary.left()) | isRemote(binary.right());
+            break;
+        }
+        case NodeType::MEMBER_EXPR:
+            remote = isRemote(static_cast<MemberExpr &>(node).object());
+            break;
+        case NodeType::CALL_EXPR:
+            for (const auto &arg: static_cast<CallExpr &>(node).args()) remote |= isRemote(*arg);
+            break;
+        case NodeType::MATCH_EXPR: {
+            const auto &match = static_cast<MatchExpr &>(node);
+            remote = isRemote(match.subject()) | isRemote(match.pattern());
+            break;
+        }
+        default:
+            break;
+    }
+
+    m_remote.emplace(&node, remote);
+    return remote;
+}
@@ -0,0 +1,101 @@
+#include "../../includes/mbs/backend/builtins.h"
+
+#include <array>
+#include <cmath>
+#include <format>
+#include <stdexcept>
+
+#include "../../includes/mbs/backend/string_kernels.h"
+
+namespace {
+    using Args = std::span<const RuntimeValue>;
+
+    const std::string &expectString(const char *fn, const RuntimeValue &val) {
+        if (!val.isString()) {
+            throw std::runtime_error(std::format("`{}` expects a string, got {}", fn, val.typeName()));
+        }
+        return val.asString();
+    }
+
+    double expectNumber(const char *fn, const RuntimeValue &val) {
+        if (!val.isNumber()) {
+            throw std::runtime_error(std::format("`{}` expects a number, got {}", fn, val.typeName()));
+        }
+        return val.asNumber();
+    }
+
+    RuntimeValue len(const Args args) {
+        return static_cast<int64_t>(expectString("len", args[0]).size());
+    }
+
+    RuntimeValue lower(const Args args) {
+        const auto &str = expectString("lower", args[0]);
+        std::string out(str.size(), '\0');
+        kernels::toLower(str.data(), out.data(), str.size());
+        return out;
+    }
+
+    RuntimeValue upper(const Args args) {
+        const auto &str = expectString("upper", args[0]);
+        std::string out(str.size(), '\0');
+        kernels::toUpper(str.data(), out.data(), str.size());
+        return out;
+    }
+
+    RuntimeValue contains(const Args args) {
+        const auto &str = expectString("contains", args[0]);
+        return kernels::find(str, expectString("contains", args[1])) != std::string::npos;
+    }
+
+    RuntimeValue startsWith(const Args args) {
+        return expectString("startsWith", args[0]).starts_with(expectString("startsWith", args[1]));
+    }
+
+    RuntimeValue endsWith(const Args args) {
+        return expectString("endsWith", args[0]).ends_with(expectString("endsWith", args[1]));
+    }
+
+    RuntimeValue abs(const Args args) {
+        // Integers stay exact, except INT64_MIN whose magnitude is not representable
+        if (args[0].isInt() && args[0].asInt() != INT64_MIN) {
+            return std::abs(args[0].asInt());
+        }
+        return std::fabs(expectNumber("abs", args[0]));
+    }
+
+    // Integers are already whole, rounding them through a double would lose precision above 2^53
+    RuntimeValue floor(const Args args) {
+        if (args[0].isInt()) return args[0];
+        return std::floor(expectNumber("floor", args[0]));
+    }
+
+    RuntimeValue ceil(const Args args) {
+        if (args[0].isInt()) return args[0];
+        return std::ceil(expectNumber("ceil", args[0]));
+    }
+
+    const std::array<Builtin, 9> registry{
+        {
+            {"len", 1, 1, true, ValueType::NUMBER, len},
+            {"lower", 1, 1, true, ValueType::STRING, lower},
+            {"upper", 1, 1, true, ValueType::STRING, upper},
+            {"contains", 2, 2, true, ValueType::BOOL, contains},
+            {"startsWith", 2, 2, true, ValueType::BOOL, startsWith},
+            {"endsWith", 2, 2, true, ValueType::BOOL, endsWith},
+            {"abs", 1, 1, true, ValueType::NUMBER, abs},
+            {"floor", 1, 1, true, ValueType::NUMBER, floor},
+            {"ceil", 1, 1, true, ValueType::NUMBER, ceil},
+        }
+    };
+}
+
+int builtins::indexOf(const std::string &name) {
+    for (std::size_t i = 0; i < registry.size(); ++i) {
+        if (registry[i].name == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+const Builtin &builtins::at(const int index) {
+    return registry.at(index);
+}
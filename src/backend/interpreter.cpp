@@ -1,2 +1,142 @@
 #include "../../includes/mbs/backend/interpreter.h"
 
+#include <algorithm>
+#include <format>
+
+#include "../../includes/mbs/backend/profiler.h"
+#include "../../includes/mbs/backend/runtime.h"
+#include "../../includes/mbs/frontend/ast.h"
+
+namespace {
+    const Interpreter::Bindings emptyBindings{};
+}
+
+const char *limitToString(const EvalBudget::Limit limit) {
+    switch (limit) {
+        case EvalBudget::Limit::NONE: return "none";
+        case EvalBudget::Limit::STEPS: return "steps";
+        case EvalBudget::Limit::MEMORY: return "memory";
+        case EvalBudget::Limit::DEADLINE: return "deadline";
+    }
+    return "unknown";
+}
+
+BudgetExceeded::BudgetExceeded(const EvalBudget::Limit limit)
+    : std::runtime_error(std::format("Evaluation exceeded its {} budget", limitToString(limit))),
+      m_limit(limit) {
+}
+
+Interpreter::Interpreter() : m_bindings(&emptyBindings) {
+}
+
+Interpreter::Interpreter(const Bindings &bindings) : m_bindings(&bindings) {
+}
+
+Interpreter::Interpreter(const void *host, const SlotReader *readers)
+    : m_bindings(&emptyBindings),
+      m_host(host),
+      m_readers(readers) {
+}
+
+RuntimeValue Interpreter::evaluate(AstNode &node) {
+    MBS_PROFILE_PHASE(Profiler::Phase::EVAL);
+    return node.eval(*this);
+}
+
+RuntimeValue Interpreter::evaluate(AstRoot &root) {
+    MBS_PROFILE_PHASE(Profiler::Phase::EVAL);
+    RuntimeValue result;
+    for (const auto &node: root.nodes()) {
+        result = node->eval(*this);
+    }
+    return result;
+}
+
+template<typename Evaluate>
+BudgetedResult Interpreter::budgeted(const EvalBudget &budget, Evaluate &&evaluate) {
+    m_budget = budget;
+    m_steps = 0;
+    m_memory = 0;
+    grant();
+
+    BudgetedResult result;
+    try {
+        result.value = evaluate();
+    } catch (const BudgetExceeded &e) {
+        result.exceeded = e.limit();
+    }
+    result.steps = m_steps + (m_granted - m_fuel);
+    result.memory = m_memory;
+
+    m_budget = {};
+    m_granted = m_fuel = UNLIMITED;
+    return result;
+}
+
+BudgetedResult Interpreter::evaluate(AstRoot &root, const EvalBudget &budget) {
+    return budgeted(budget, [&] { return evaluate(root); });
+}
+
+BudgetedResult Interpreter::evaluate(AstRoot &root, const EvalBudget &budget, EvalScratch &scratch) {
+    return budgeted(budget, [&] {
+        const auto results = evaluate(root, scratch);
+        return results.empty() ? RuntimeValue{} : results.back();
+    });
+}
+
+std::span<const RuntimeValue> Interpreter::evaluate(AstRoot &root, EvalScratch &scratch) {
+    MBS_PROFILE_PHASE(Profiler::Phase::EVAL);
+    const auto &nodes = root.nodes();
+    scratch.results.resize(nodes.size());
+
+    m_patternScratch = &scratch.pattern;
+    try {
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            scratch.results[i] = nodes[i]->eval(*this);
+        }
+    } catch (...) {
+        m_patternScratch = nullptr;
+        throw;
+    }
+    m_patternScratch = nullptr;
+    return scratch.results;
+}
+
+void Interpreter::refuel() {
+    // The step that emptied the tank is included
+    m_steps += m_granted;
+    m_granted = m_fuel = 0;
+
+    if (m_budget.maxSteps && m_steps > m_budget.maxSteps) {
+        throw BudgetExceeded(EvalBudget::Limit::STEPS);
+    }
+    if (m_budget.deadline && std::chrono::steady_clock::now() >= *m_budget.deadline) {
+        throw BudgetExceeded(EvalBudget::Limit::DEADLINE);
+    }
+
+    grant();
+}
+
+void Interpreter::grant() {
+    // One extra step so that running out means the limit was actually exceeded
+    uint64_t allowance = m_budget.deadline ? DEADLINE_CHECK_INTERVAL : UNLIMITED;
+    if (m_budget.maxSteps) allowance = std::min(allowance, m_budget.maxSteps - m_steps + 1);
+    m_granted = m_fuel = allowance;
+}
+
+void Interpreter::chargeBytes(const std::size_t bytes) {
+    m_memory += bytes;
+    if (m_memory > m_budget.maxMemory) {
+        throw BudgetExceeded(EvalBudget::Limit::MEMORY);
+    }
+}
+
+RuntimeValue Interpreter::lookup(const std::string &ident) const {
+    const auto *val = find(ident);
+    return val ? *val : RuntimeValue{};
+}
+
+const RuntimeValue *Interpreter::find(const std::string &ident) const {
+    const auto it = m_bindings->find(ident);
+    return it == m_bindings->end() ? nullptr : &it->second;
+}
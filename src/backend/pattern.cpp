@@ -0,0 +1,492 @@
+#include "../../includes/mbs/backend/pattern.h"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <format>
+#include <map>
+#include <optional>
+#include <stdexcept>
+
+#include "../../includes/mbs/backend/string_kernels.h"
+
+namespace {
+    // Past this many states the DFA tables cost more than simulating the NFA
+    constexpr std::size_t MAX_DFA_STATES = 1024;
+    constexpr std::size_t DEFAULT_CACHE_CAPACITY = 256;
+
+    using ByteSet = std::array<uint64_t, 4>;
+
+    void addByte(ByteSet &set, const unsigned char c) {
+        set[c >> 6] |= uint64_t{1} << (c & 63);
+    }
+
+    bool hasByte(const ByteSet &set, const unsigned char c) {
+        return set[c >> 6] >> (c & 63) & 1;
+    }
+
+    void addRange(ByteSet &set, const unsigned char lo, const unsigned char hi) {
+        for (int c = lo; c <= hi; ++c) addByte(set, static_cast<unsigned char>(c));
+    }
+
+    ByteSet negate(ByteSet set) {
+        for (auto &word: set) word = ~word;
+        return set;
+    }
+
+    // `\d`, `\w`, `\s` and their upper-case negations
+    std::optional<ByteSet> shorthandClass(const char c) {
+        ByteSet set{};
+        switch (c) {
+            case 'd':
+            case 'D':
+                addRange(set, '0', '9');
+                break;
+            case 'w':
+            case 'W':
+                addRange(set, '0', '9');
+                addRange(set, 'a', 'z');
+                addRange(set, 'A', 'Z');
+                addByte(set, '_');
+                break;
+            case 's':
+            case 'S':
+                for (const char ws: std::string_view{" \t\n\r\f\v"}) addByte(set, ws);
+                break;
+            default:
+                return std::nullopt;
+        }
+        return std::isupper(static_cast<unsigned char>(c)) ? negate(set) : set;
+    }
+
+    char escapedByte(const char c) {
+        if (c == 'n') return '\n';
+        if (c == 't') return '\t';
+        if (c == 'r') return '\r';
+        return c;
+    }
+
+    bool isMeta(const char c) {
+        return std::string_view{".[]()|*+?^$"}.find(c) != std::string_view::npos;
+    }
+
+    // The text `source` matches when it holds no operators, `nullopt` otherwise
+    std::optional<std::string> literalOf(const std::string_view source) {
+        std::string literal;
+        for (std::size_t i = 0; i < source.size(); ++i) {
+            if (isMeta(source[i])) return std::nullopt;
+            if (source[i] != '\\') {
+                literal += source[i];
+                continue;
+            }
+            if (++i == source.size() || shorthandClass(source[i])) return std::nullopt;
+            literal += escapedByte(source[i]);
+        }
+        return literal;
+    }
+
+    // Whether the character at `pos` is preceded by an odd number of backslashes
+    bool isEscaped(const std::string_view source, std::size_t pos) {
+        bool escaped = false;
+        while (pos > 0 && source[--pos] == '\\') escaped = !escaped;
+        return escaped;
+    }
+}
+
+// Thompson construction of the pattern NFA
+class PatternCompiler {
+public:
+    PatternCompiler(Pattern &pattern, const std::string_view source)
+        : m_pattern(pattern),
+          m_src(source) {
+    }
+
+    void compile() {
+        auto frag = parseAlt();
+        if (m_pos < m_src.size()) error("unbalanced `)`");
+
+        Pattern::NfaState match;
+        match.type = Pattern::NfaState::Type::MATCH;
+        patch(frag, addState(match));
+        m_pattern.m_nfaStart = frag.start;
+    }
+
+private:
+    using State = Pattern::NfaState;
+
+    struct Frag {
+        int start;
+        std::vector<std::pair<int, bool> > outs; // Dangling (state, is `out1`) edges
+    };
+
+    [[noreturn]] void error(const std::string &msg) const {
+        throw std::runtime_error(std::format("Invalid pattern `{}`: {} at offset {}",
+                                             m_pattern.m_source, msg, m_pos));
+    }
+
+    int addState(const State &state) {
+        m_pattern.m_nfa.push_back(state);
+        return static_cast<int>(m_pattern.m_nfa.size()) - 1;
+    }
+
+    void patch(const Frag &frag, const int target) {
+        for (const auto &[state, second]: frag.outs) {
+            (second ? m_pattern.m_nfa[state].out1 : m_pattern.m_nfa[state].out) = target;
+        }
+    }
+
+    Frag bytes(const ByteSet &set) {
+        State state;
+        state.type = State::Type::BYTES;
+        state.bytes = set;
+        const int id = addState(state);
+        return {id, {{id, false}}};
+    }
+
+    Frag split(const int target) {
+        State state;
+        state.out = target;
+        const int id = addState(state);
+        return {id, {{id, true}}};
+    }
+
+    [[nodiscard]] bool atEnd() const { return m_pos >= m_src.size(); }
+    [[nodiscard]] char peek() const { return m_src[m_pos]; }
+
+    Frag parseAlt() {
+        auto left = parseConcat();
+        while (!atEnd() && peek() == '|') {
+            ++m_pos;
+            auto right = parseConcat();
+
+            auto fork = split(left.start);
+            m_pattern.m_nfa[fork.start].out1 = right.start;
+            fork.outs = std::move(left.outs);
+            fork.outs.insert(fork.outs.end(), right.outs.begin(), right.outs.end());
+            left = std::move(fork);
+        }
+        return left;
+    }
+
+    Frag parseConcat() {
+        std::optional<Frag> seq;
+        while (!atEnd() && peek() != '|' && peek() != ')') {
+            auto next = parseRepeat();
+            if (!seq) {
+                seq = std::move(next);
+                continue;
+            }
+            patch(*seq, next.start);
+            seq->outs = std::move(next.outs);
+        }
+
+        if (seq) return std::move(*seq);
+
+        // Empty branch, a bare epsilon edge
+        State state;
+        const int id = addState(state);
+        return {id, {{id, false}}};
+    }
+
+    Frag parseRepeat() {
+        auto frag = parseAtom();
+        while (!atEnd() && (peek() == '*' || peek() == '+' || peek() == '?')) {
+            const char op = m_src[m_pos++];
+            auto loop = split(frag.start);
+
+            if (op == '*') {
+                patch(frag, loop.start);
+                frag = std::move(loop);
+            } else if (op == '+') {
+                patch(frag, loop.start);
+                frag.outs = std::move(loop.outs);
+            } else {
+                loop.outs.insert(loop.outs.end(), frag.outs.begin(), frag.outs.end());
+                frag = std::move(loop);
+            }
+        }
+        return frag;
+    }
+
+    Frag parseAtom() {
+        const char c = m_src[m_pos++];
+        switch (c) {
+            case '(': {
+                // Groups recurse back into `parseAlt`, so their nesting bounds the stack depth
+                if (++m_depth > Pattern::MAX_GROUP_DEPTH) {
+                    --m_pos;
+                    error(std::format("groups nested deeper than {}", Pattern::MAX_GROUP_DEPTH));
+                }
+                auto inner = parseAlt();
+                if (atEnd() || peek() != ')') error("missing `)`");
+                ++m_pos;
+                --m_depth;
+                return inner;
+            }
+            case '[':
+                return bytes(parseClass());
+            case '.':
+                return bytes(negate(ByteSet{}));
+            case '\\':
+                return bytes(parseEscape());
+            case '*':
+            case '+':
+            case '?':
+                --m_pos;
+                error("nothing to repeat");
+            case ')':
+            case '^':
+            case '$':
+                --m_pos;
+                error(std::format("unexpected `{}`", c));
+            default: {
+                ByteSet set{};
+                addByte(set, c);
+                return bytes(set);
+            }
+        }
+    }
+
+    ByteSet parseEscape() {
+        if (atEnd()) error("trailing `\\`");
+        const char c = m_src[m_pos++];
+        if (const auto set = shorthandClass(c)) return *set;
+
+        ByteSet set{};
+        addByte(set, escapedByte(c));
+        return set;
+    }
+
+    ByteSet parseClass() {
+        ByteSet set{};
+        const bool negated = !atEnd() && peek() == '^';
+        if (negated) ++m_pos;
+
+        bool first = true;
+        while (!atEnd() && (peek() != ']' || first)) {
+            first = false;
+
+            unsigned char lo = m_src[m_pos++];
+            if (lo == '\\') {
+                const auto escaped = parseEscape();
+                if (std::popcount(escaped[0]) + std::popcount(escaped[1])
+                    + std::popcount(escaped[2]) + std::popcount(escaped[3]) != 1) {
+                    for (int i = 0; i < 4; ++i) set[i] |= escaped[i];
+                    continue;
+                }
+                lo = escapedByte(m_src[m_pos - 1]);
+            }
+
+            if (m_pos + 1 < m_src.size() && peek() == '-' && m_src[m_pos + 1] != ']') {
+                ++m_pos;
+                unsigned char hi = m_src[m_pos++];
+                if (hi == '\\') {
+                    if (atEnd()) error("trailing `\\`");
+                    hi = escapedByte(m_src[m_pos++]);
+                }
+                if (hi < lo) error("reversed class range");
+                addRange(set, lo, hi);
+            } else {
+                addByte(set, lo);
+            }
+        }
+
+        if (atEnd()) error("missing `]`");
+        ++m_pos; // Consume `]`
+        return negated ? negate(set) : set;
+    }
+
+    Pattern &m_pattern;
+    std::string_view m_src;
+    std::size_t m_pos = 0;
+    int m_depth = 0; // Groups currently open
+};
+
+std::shared_ptr<const Pattern> Pattern::compile(std::string_view source) {
+    if (source.size() > MAX_LENGTH) {
+        throw std::runtime_error(std::format("Invalid pattern: longer than {} bytes", MAX_LENGTH));
+    }
+
+    auto pattern = std::make_shared<Pattern>();
+    pattern->m_source = source;
+
+    // Patterns are always anchored, explicit anchors are redundant
+    if (source.starts_with('^')) source.remove_prefix(1);
+    if (source.ends_with('$') && !isEscaped(source, source.size() - 1)) source.remove_suffix(1);
+    const auto unanchored = source;
+
+    // Literal fast paths: `lit`, `lit.*`, `.*lit` and `.*lit.*`
+    const bool anyPrefix = source.starts_with(".*");
+    if (anyPrefix) source.remove_prefix(2);
+    const bool anySuffix = source.ends_with(".*") && !isEscaped(source, source.size() - 2);
+    const auto body = anySuffix ? source.substr(0, source.size() - 2) : source;
+
+    if (const auto literal = literalOf(body)) {
+        pattern->m_literal = *literal;
+        pattern->m_kind = anyPrefix
+                              ? anySuffix ? Kind::SUBSTRING : Kind::SUFFIX
+                              : anySuffix ? Kind::PREFIX : Kind::EXACT;
+        return pattern;
+    }
+
+    PatternCompiler compiler{*pattern, unanchored};
+    compiler.compile();
+    pattern->m_kind = pattern->buildDfa() ? Kind::DFA : Kind::NFA;
+    return pattern;
+}
+
+bool Pattern::matches(const std::string_view subject) const {
+    // Empty buffers don't allocate, so only NFA patterns pay for a fresh scratch
+    Scratch scratch;
+    return matches(subject, scratch);
+}
+
+bool Pattern::matches(const std::string_view subject, Scratch &scratch) const {
+    switch (m_kind) {
+        case Kind::EXACT:
+            return subject == m_literal;
+        case Kind::PREFIX:
+            return subject.starts_with(m_literal);
+        case Kind::SUFFIX:
+            return subject.ends_with(m_literal);
+        case Kind::SUBSTRING:
+            return kernels::find(subject, m_literal) != std::string_view::npos;
+        case Kind::DFA: {
+            int32_t state = 0;
+            for (const char c: subject) {
+                state = m_transitions[static_cast<std::size_t>(state) * 256 + static_cast<unsigned char>(c)];
+                if (state < 0) return false;
+            }
+            return m_accepting[state];
+        }
+        default:
+            return simulateNfa(subject, scratch);
+    }
+}
+
+void Pattern::closure(std::vector<int> &states, std::vector<uint8_t> &onList, std::vector<int> &pending,
+                      const int state) const {
+    // Depth first with an explicit stack, epsilon chains can be as long as the pattern
+    pending.clear();
+    pending.push_back(state);
+    while (!pending.empty()) {
+        const int cur = pending.back();
+        pending.pop_back();
+        if (cur < 0 || onList[cur]) continue;
+        onList[cur] = 1;
+
+        const auto &nfa = m_nfa[cur];
+        if (nfa.type != NfaState::Type::SPLIT) {
+            states.push_back(cur);
+            continue;
+        }
+        pending.push_back(nfa.out1);
+        pending.push_back(nfa.out);
+    }
+}
+
+bool Pattern::buildDfa() {
+    // Subset construction, DFA state `i` stands for the NFA state set `sets[i]`
+    std::map<std::vector<int>, int32_t> ids;
+    std::vector<std::vector<int> > sets;
+    std::vector<uint8_t> onList(m_nfa.size());
+    std::vector<int> pending;
+
+    const auto intern = [&](std::vector<int> set) -> int32_t {
+        std::ranges::sort(set);
+        const auto [it, inserted] = ids.emplace(set, static_cast<int32_t>(sets.size()));
+        if (inserted) sets.push_back(std::move(set));
+        return it->second;
+    };
+
+    std::vector<int> start;
+    closure(start, onList, pending, m_nfaStart);
+    intern(std::move(start));
+
+    for (std::size_t i = 0; i < sets.size(); ++i) {
+        if (sets.size() > MAX_DFA_STATES) {
+            m_transitions.clear();
+            m_accepting.clear();
+            return false;
+        }
+
+        bool accepting = false;
+        for (const int s: sets[i]) accepting = accepting || m_nfa[s].type == NfaState::Type::MATCH;
+        m_accepting.push_back(accepting);
+
+        for (int c = 0; c < 256; ++c) {
+            std::vector<int> next;
+            std::ranges::fill(onList, 0);
+            for (const int s: sets[i]) {
+                const auto &nfa = m_nfa[s];
+                if (nfa.type == NfaState::Type::BYTES && hasByte(nfa.bytes, static_cast<unsigned char>(c)))
+                    closure(next, onList, pending, nfa.out);
+            }
+            m_transitions.push_back(next.empty() ? -1 : intern(std::move(next)));
+        }
+    }
+
+    return true;
+}
+
+bool Pattern::simulateNfa(const std::string_view subject, Scratch &scratch) const {
+    auto &[current, next, pending, onList] = scratch;
+    current.clear();
+    onList.assign(m_nfa.size(), 0);
+    closure(current, onList, pending, m_nfaStart);
+
+    for (const char c: subject) {
+        next.clear();
+        std::ranges::fill(onList, 0);
+        for (const int s: current) {
+            const auto &nfa = m_nfa[s];
+            if (nfa.type == NfaState::Type::BYTES && hasByte(nfa.bytes, static_cast<unsigned char>(c)))
+                closure(next, onList, pending, nfa.out);
+        }
+        if (next.empty()) return false;
+        std::swap(current, next);
+    }
+
+    for (const int s: current) {
+        if (m_nfa[s].type == NfaState::Type::MATCH) return true;
+    }
+    return false;
+}
+
+PatternCache::PatternCache(const std::size_t capacity) : m_capacity(capacity) {
+}
+
+PatternCache &PatternCache::global() {
+    static PatternCache cache{DEFAULT_CACHE_CAPACITY};
+    return cache;
+}
+
+std::shared_ptr<const Pattern> PatternCache::get(const std::string_view source) {
+    {
+        std::lock_guard lock{m_mutex};
+        if (const auto it = m_index.find(source); it != m_index.end()) {
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            return it->second->second;
+        }
+    }
+
+    // Compile outside the lock, a concurrent miss on the same source just wins the race
+    auto pattern = Pattern::compile(source);
+
+    std::lock_guard lock{m_mutex};
+    if (const auto it = m_index.find(source); it != m_index.end()) return it->second->second;
+
+    m_lru.emplace_front(std::string{source}, pattern);
+    m_index.emplace(m_lru.front().first, m_lru.begin());
+
+    if (m_lru.size() > m_capacity) {
+        m_index.erase(m_lru.back().first);
+        m_lru.pop_back();
+    }
+    return pattern;
+}
+
+std::size_t PatternCache::size() const {
+    std::lock_guard lock{m_mutex};
+    return m_lru.size();
+}
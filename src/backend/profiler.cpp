@@ -0,0 +1,210 @@
+#include "../../includes/mbs/backend/profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <x86intrin.h>
+#endif
+
+#include "../../includes/mbs/frontend/ast.h"
+
+namespace {
+    thread_local Profiler *activeProfiler = nullptr;
+
+    uint64_t cycles() {
+#if defined(__x86_64__) || defined(_M_X64)
+        return __rdtsc();
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    uint64_t nanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    std::string describe(const AstNode &node) {
+        switch (node.type) {
+            case NodeType::UNARY_EXPR:
+                return std::format("{}({})", node.name, static_cast<const UnaryExpr &>(node).op());
+            case NodeType::BINARY_EXPR:
+                return std::format("{}({})", node.name, static_cast<const BinaryExpr &>(node).op());
+            case NodeType::MEMBER_EXPR: {
+                std::string path;
+                for (const auto &field: static_cast<const MemberExpr &>(node).path()) path += "." + field;
+                return std::format("{}({})", node.name, path);
+            }
+            case NodeType::CALL_EXPR:
+                return std::format("{}({})", node.name,
+                                   builtins::at(static_cast<const CallExpr &>(node).builtin()).name);
+            case NodeType::IDENTIFIER:
+                return std::format("{}({})", node.name, static_cast<const IdentifierExpr &>(node).ident());
+            case NodeType::NUMBER_LITERAL:
+                return std::format("{}({})", node.name,
+                                   static_cast<const NumberLiteral &>(node).value().toString());
+            case NodeType::BOOLEAN_LITERAL:
+                return std::format("{}({})", node.name,
+                                   static_cast<const BooleanLiteral &>(node).value() ? "true" : "false");
+            default:
+                return node.name;
+        }
+    }
+
+    // Frame names can't contain the `;` separator or the space before the count
+    std::string foldedFrame(std::string label) {
+        std::ranges::replace(label, ';', ':');
+        std::ranges::replace(label, ' ', '_');
+        return label;
+    }
+
+    void writeJsonString(std::ostream &out, const std::string &str) {
+        out << '"';
+        for (const char c: str) {
+            switch (c) {
+                case '"': out << "\\\"";
+                    break;
+                case '\\': out << "\\\\";
+                    break;
+                case '\n': out << "\\n";
+                    break;
+                case '\t': out << "\\t";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        out << std::format("\\u{:04x}", static_cast<int>(c));
+                    } else {
+                        out << c;
+                    }
+            }
+        }
+        out << '"';
+    }
+}
+
+// ------------ SCOPES -------------------- //
+Profiler::Session::Session(Profiler &profiler) : m_previous(activeProfiler) {
+    activeProfiler = &profiler;
+}
+
+Profiler::Session::~Session() {
+    activeProfiler = m_previous;
+}
+
+Profiler::NodeScope::NodeScope(const AstNode &node) : m_profiler(activeProfiler) {
+    if (m_profiler) m_profiler->enter(node);
+}
+
+Profiler::NodeScope::~NodeScope() {
+    if (m_profiler) m_profiler->leave();
+}
+
+Profiler::PhaseScope::PhaseScope(const Phase phase) : m_profiler(activeProfiler), m_phase(phase) {
+    if (m_profiler) m_start = nanos();
+}
+
+Profiler::PhaseScope::~PhaseScope() {
+    if (m_profiler) m_profiler->recordPhase(m_phase, nanos() - m_start);
+}
+
+// ------------ PROFILER -------------------- //
+Profiler *Profiler::active() {
+    return activeProfiler;
+}
+
+void Profiler::enter(const AstNode &node) {
+    auto [it, inserted] = m_index.try_emplace(&node, m_nodes.size());
+    if (inserted) {
+        // The AST is a tree, so a node's first parent is its only one
+        m_nodes.push_back(NodeStats{
+            .label = describe(node),
+            .parent = m_stack.empty() ? NO_PARENT : m_stack.back().stats,
+        });
+    }
+    m_stack.push_back(Frame{.stats = it->second, .start = cycles()});
+}
+
+void Profiler::leave() {
+    const auto frame = m_stack.back();
+    m_stack.pop_back();
+
+    const auto elapsed = cycles() - frame.start;
+    auto &stats = m_nodes[frame.stats];
+    stats.count++;
+    stats.cycles += elapsed;
+    stats.selfCycles += elapsed > frame.children ? elapsed - frame.children : 0;
+    if (!m_stack.empty()) m_stack.back().children += elapsed;
+}
+
+void Profiler::recordPhase(const Phase phase, const uint64_t nanos) {
+    auto &stats = m_phases[static_cast<int>(phase)];
+    stats.calls++;
+    stats.nanos += nanos;
+}
+
+void Profiler::reset() {
+    m_index.clear();
+    m_nodes.clear();
+    m_stack.clear();
+    std::ranges::fill(m_phases, PhaseStats{});
+}
+
+std::vector<std::size_t> Profiler::hottest(const std::size_t n) const {
+    std::vector<std::size_t> order(m_nodes.size());
+    for (std::size_t i = 0; i < order.size(); ++i) order[i] = i;
+
+    const auto top = std::min(n, order.size());
+    std::ranges::partial_sort(order, order.begin() + static_cast<std::ptrdiff_t>(top),
+                              [&](const std::size_t a, const std::size_t b) {
+                                  return m_nodes[a].selfCycles > m_nodes[b].selfCycles;
+                              });
+    order.resize(top);
+    return order;
+}
+
+void Profiler::writeJson(std::ostream &out) const {
+    out << "{\"phases\":{";
+    for (int i = 0; i < 4; ++i) {
+        out << (i ? "," : "") << '"' << phaseToString(static_cast<Phase>(i)) << "\":";
+        out << "{\"calls\":" << m_phases[i].calls << ",\"nanos\":" << m_phases[i].nanos << '}';
+    }
+
+    out << "},\"nodes\":[";
+    for (std::size_t i = 0; i < m_nodes.size(); ++i) {
+        const auto &stats = m_nodes[i];
+        out << (i ? "," : "") << "{\"id\":" << i << ",\"label\":";
+        writeJsonString(out, stats.label);
+        out << ",\"parent\":";
+        if (stats.parent == NO_PARENT) out << "null";
+        else out << stats.parent;
+        out << ",\"count\":" << stats.count << ",\"cycles\":" << stats.cycles;
+        out << ",\"selfCycles\":" << stats.selfCycles << '}';
+    }
+    out << "]}";
+}
+
+void Profiler::writeFolded(std::ostream &out) const {
+    std::vector<std::size_t> chain;
+    for (std::size_t i = 0; i < m_nodes.size(); ++i) {
+        if (m_nodes[i].selfCycles == 0) continue;
+
+        chain.clear();
+        for (auto at = i; at != NO_PARENT; at = m_nodes[at].parent) chain.push_back(at);
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            out << (it == chain.rbegin() ? "" : ";") << foldedFrame(m_nodes[*it].label);
+        }
+        out << ' ' << m_nodes[i].selfCycles << '\n';
+    }
+}
+
+const char *phaseToString(const Profiler::Phase phase) {
+    switch (phase) {
+        case Profiler::Phase::LEX: return "lex";
+        case Profiler::Phase::PARSE: return "parse";
+        case Profiler::Phase::COMPILE: return "compile";
+        case Profiler::Phase::EVAL: return "eval";
+    }
+    return "unknown";
+}
@@ -0,0 +1,146 @@
+#include "../../includes/mbs/backend/reactive.h"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+#include "../../includes/mbs/frontend/ast.h"
+
+static_assert(builtins::MAX_ARGS <= 3, "Memo::children must fit every builtin argument");
+
+ReactiveEvaluator::ReactiveEvaluator(Interpreter::Bindings bindings)
+    : m_bindings(std::move(bindings)),
+      m_interp(m_bindings) {
+}
+
+ReactiveEvaluator::ExprId ReactiveEvaluator::add(AstNode &expr) {
+    m_roots.push_back(track(expr, NO_PARENT));
+    return m_roots.size() - 1;
+}
+
+void ReactiveEvaluator::set(const std::string &name, RuntimeValue value) {
+    m_bindings.insert_or_assign(name, std::move(value));
+
+    const auto it = m_readers.find(name);
+    if (it == m_readers.end()) return;
+
+    // Walks all the way up rather than stopping at the first dirty node, a short-circuited
+    // `&&`/`||` can be clean while the operand it skipped is still dirty
+    for (auto index: it->second) {
+        for (; index != NO_PARENT; index = m_memos[index].parent) {
+            m_memos[index].dirty = true;
+        }
+    }
+}
+
+const RuntimeValue &ReactiveEvaluator::value(const ExprId id) {
+    if (id >= m_roots.size()) {
+        throw std::runtime_error(std::format("Unknown expression id {}", id));
+    }
+    return compute(m_roots[id]);
+}
+
+std::vector<std::string> ReactiveEvaluator::dependencies(const ExprId id) const {
+    if (id >= m_roots.size()) {
+        throw std::runtime_error(std::format("Unknown expression id {}", id));
+    }
+
+    std::vector<std::string> names;
+    for (const auto &[name, readers]: m_readers) {
+        for (auto index: readers) {
+            while (m_memos[index].parent != NO_PARENT) index = m_memos[index].parent;
+            if (index == m_roots[id]) {
+                names.push_back(name);
+                break;
+            }
+        }
+    }
+    std::ranges::sort(names);
+    return names;
+}
+
+void ReactiveEvaluator::resetCounters() {
+    m_recomputed = 0;
+    m_reused = 0;
+}
+
+uint32_t ReactiveEvaluator::track(AstNode &node, const uint32_t parent) {
+    const auto index = static_cast<uint32_t>(m_memos.size());
+    m_memos.push_back(Memo{.node = &node, .parent = parent, .arity = 0, .dirty = true, .children = {}, .value = {}});
+
+    const auto child = [&](AstNode &of) {
+        const auto at = track(of, index);
+        auto &memo = m_memos[index];
+        memo.children[memo.arity++] = at;
+    };
+
+    switch (node.type) {
+        case NodeType::IDENTIFIER:
+            m_readers[static_cast<IdentifierExpr &>(node).ident()].push_back(index);
+            break;
+        case NodeType::UNARY_EXPR:
+            child(static_cast<UnaryExpr &>(node).expr());
+            break;
+        case NodeType::BINARY_EXPR:
+            child(static_cast<BinaryExpr &>(node).left());
+            child(static_cast<BinaryExpr &>(node).right());
+            break;
+        case NodeType::MEMBER_EXPR:
+            child(static_cast<MemberExpr &>(node).object());
+            break;
+        case NodeType::CALL_EXPR:
+            for (const auto &arg: static_cast<CallExpr &>(node).args()) child(*arg);
+            break;
+        case NodeType::MATCH_EXPR:
+            child(static_cast<MatchExpr &>(node).subject());
+            child(static_cast<MatchExpr &>(node).pattern());
+            break;
+        default:
+            break;
+    }
+    return index;
+}
+
+const RuntimeValue &ReactiveEvaluator::compute(const uint32_t index) {
+    auto &memo = m_memos[index];
+    if (!memo.dirty) {
+        m_reused++;
+        return memo.value;
+    }
+
+    m_recomputed++;
+    auto &node = *memo.node;
+    const auto arg = [&](const int i) -> const RuntimeValue &{ return compute(memo.children[i]); };
+
+    switch (node.type) {
+        case NodeType::UNARY_EXPR:
+            memo.value = applyUnaryOp(static_cast<UnaryExpr &>(node).op(), arg(0));
+            break;
+        case NodeType::BINARY_EXPR: {
+            const auto &op = static_cast<BinaryExpr &>(node).op();
+            if (op == "&&") memo.value = arg(0).isTruthy() && arg(1).isTruthy();
+            else if (op == "||") memo.value = arg(0).isTruthy() || arg(1).isTruthy();
+            else memo.value = applyBinaryOp(op, arg(0), arg(1));
+            break;
+        }
+        case NodeType::MEMBER_EXPR:
+            memo.value = static_cast<MemberExpr &>(node).access(arg(0));
+            break;
+        case NodeType::CALL_EXPR: {
+            std::array<RuntimeValue, builtins::MAX_ARGS> args;
+            for (int i = 0; i < memo.arity; ++i) args[i] = arg(i);
+            memo.value = builtins::at(static_cast<CallExpr &>(node).builtin()).fn({args.data(), memo.arity});
+            break;
+        }
+        case NodeType::MATCH_EXPR:
+            memo.value = static_cast<MatchExpr &>(node).match(arg(0), arg(1));
+            break;
+        default:
+            // Literals and identifiers have no children to reuse
+            memo.value = node.eval(m_interp);
+            break;
+    }
+
+    memo.dirty = false;
+    return memo.value;
+}
@@ -0,0 +1,243 @@
+#include "../../includes/mbs/backend/rule_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "../../includes/mbs/frontend/ast.h"
+#include "../../includes/mbs/frontend/parser.h"
+
+namespace {
+    // Rough selectivity weights used to pick the cheapest guard set of a conjunction
+    constexpr int EQUALITY_COST = 1;
+    constexpr int RANGE_COST = 4;
+
+    std::optional<RuntimeValue> literalOf(const AstNode &node) {
+        switch (node.type) {
+            case NodeType::NUMBER_LITERAL:
+                return static_cast<const NumberLiteral &>(node).value();
+            case NodeType::STRING_LITERAL:
+                return static_cast<const StringLiteral &>(node).value();
+            case NodeType::BOOLEAN_LITERAL:
+                return static_cast<const BooleanLiteral &>(node).value();
+            case NodeType::NULL_LITERAL:
+                return RuntimeValue{};
+            case NodeType::UNARY_EXPR: {
+                // Negative numbers are parsed as `-` applied to a number literal
+                const auto &unary = static_cast<const UnaryExpr &>(node);
+                if (unary.op() == "-" && unary.expr().type == NodeType::NUMBER_LITERAL)
+                    return applyUnaryOp("-", static_cast<const NumberLiteral &>(unary.expr()).value());
+                return std::nullopt;
+            }
+            default:
+                return std::nullopt;
+        }
+    }
+
+    const auto numberLess = [](const RuntimeValue &lhs, const RuntimeValue &rhs) {
+        return compareNumbers(lhs, rhs) < 0;
+    };
+
+    std::string flipComparison(const std::string &op) {
+        if (op == "<") return ">";
+        if (op == "<=") return ">=";
+        if (op == ">") return "<";
+        if (op == ">=") return "<=";
+        return op;
+    }
+}
+
+RuleIndex::RuleIndex() = default;
+
+RuleIndex::~RuleIndex() = default;
+
+RuleIndex::RuleId RuleIndex::addRule(const std::string &source) {
+    mbs::Parser parser;
+    parser.parse(source);
+
+    auto nodes = parser.root().takeNodes();
+    if (nodes.size() != 1) {
+        throw std::runtime_error(std::format("Expected a single rule expression, got {}", nodes.size()));
+    }
+
+    return addRule(std::move(nodes.front()));
+}
+
+RuleIndex::RuleId RuleIndex::addRule(std::unique_ptr<AstNode> rule) {
+    const RuleId id = m_rules.size();
+
+    if (const auto guards = guardsOf(*rule)) {
+        for (const auto &atom: *guards) indexAtom(atom, id);
+    } else {
+        m_unindexed.push_back(id);
+    }
+
+    m_rules.push_back(std::move(rule));
+    m_seen.push_back(0);
+    return id;
+}
+
+std::vector<RuleIndex::RuleId> RuleIndex::candidates(const Interpreter::Bindings &record) {
+    ++m_epoch;
+    std::vector<RuleId> out;
+
+    for (const auto id: m_unindexed) collect(id, out);
+
+    for (auto &[ident, values]: m_equality) {
+        const auto field = record.find(ident);
+        const auto it = values.find(field == record.end() ? RuntimeValue{} : field->second);
+        if (it == values.end()) continue;
+        for (const auto id: it->second) collect(id, out);
+    }
+
+    for (auto &[ident, ranges]: m_ranges) {
+        const auto field = record.find(ident);
+        if (field == record.end()) continue;
+
+        const auto &val = field->second;
+        // NaN never compares true
+        if (val.isNumber() && !val.isInt() && std::isnan(val.asNumber())) continue;
+
+        for (int op = 0; op < 4; ++op) {
+            if (val.isNumber())
+                collectRange(ranges.numbers[op], static_cast<RangeOp>(op), val, numberLess, out);
+            else if (val.isString())
+                collectRange(ranges.strings[op], static_cast<RangeOp>(op), val.asString(), std::ranges::less{}, out);
+        }
+    }
+
+    std::ranges::sort(out);
+    return out;
+}
+
+std::vector<RuleIndex::RuleId> RuleIndex::match(const Interpreter::Bindings &record) {
+    std::vector<RuleId> matched;
+    Interpreter interp{record};
+
+    for (const auto id: candidates(record)) {
+        try {
+            if (interp.evaluate(*m_rules[id]).isTruthy()) matched.push_back(id);
+        } catch (const std::runtime_error &) {
+            // A rule that can't be evaluated against this record doesn't match it
+        }
+    }
+
+    return matched;
+}
+
+std::optional<std::vector<RuleIndex::Atom> > RuleIndex::guardsOf(const AstNode &node) {
+    if (node.type != NodeType::BINARY_EXPR) return std::nullopt;
+
+    const auto &expr = static_cast<const BinaryExpr &>(node);
+    if (expr.op() == "&&") {
+        // Either side being true is necessary, keep the cheaper one
+        auto left = guardsOf(expr.left());
+        auto right = guardsOf(expr.right());
+        if (!left || !right) return left ? left : right;
+
+        const auto cost = [](const std::vector<Atom> &atoms) {
+            int total = 0;
+            for (const auto &atom: atoms) total += atom.op == "==" ? EQUALITY_COST : RANGE_COST;
+            return total;
+        };
+        return cost(*left) <= cost(*right) ? left : right;
+    }
+
+    if (expr.op() == "||") {
+        // Both sides need a guard, otherwise the unguarded side may match anything
+        auto left = guardsOf(expr.left());
+        auto right = guardsOf(expr.right());
+        if (!left || !right) return std::nullopt;
+
+        left->insert(left->end(), right->begin(), right->end());
+        return left;
+    }
+
+    if (auto atom = atomOf(node)) return std::vector{std::move(*atom)};
+    return std::nullopt;
+}
+
+std::optional<RuleIndex::Atom> RuleIndex::atomOf(const AstNode &node) {
+    const auto &expr = static_cast<const BinaryExpr &>(node);
+    const auto &op = expr.op();
+    if (op != "==" && op != "<" && op != "<=" && op != ">" && op != ">=") return std::nullopt;
+
+    // Normalize `lit op ident` into `ident op' lit`
+    const AstNode *ident = &expr.left(), *lit = &expr.right();
+    std::string atomOp = op;
+    if (ident->type != NodeType::IDENTIFIER) {
+        std::swap(ident, lit);
+        atomOp = flipComparison(op);
+    }
+    if (ident->type != NodeType::IDENTIFIER) return std::nullopt;
+
+    auto value = literalOf(*lit);
+    if (!value) return std::nullopt;
+
+    if (atomOp != "==") {
+        // Range atoms only ever hold for numbers or strings; NaN never compares true
+        if (!value->isNumber() && !value->isString()) return std::nullopt;
+        if (value->isNumber() && !value->isInt() && std::isnan(value->asNumber())) return std::nullopt;
+    }
+
+    return Atom{static_cast<const IdentifierExpr *>(ident)->ident(), atomOp, std::move(*value)};
+}
+
+void RuleIndex::indexAtom(const Atom &atom, const RuleId id) {
+    if (atom.op == "==") {
+        m_equality[atom.ident][atom.value].push_back(id);
+        return;
+    }
+
+    RangeOp op = RangeOp::LESS;
+    if (atom.op == "<=") op = RangeOp::LESS_OR_EQUALS;
+    else if (atom.op == ">") op = RangeOp::GREATER;
+    else if (atom.op == ">=") op = RangeOp::GREATER_OR_EQUALS;
+
+    auto &ranges = m_ranges[atom.ident];
+    if (atom.value.isNumber()) {
+        auto &bounds = ranges.numbers[static_cast<int>(op)];
+        bounds.entries.emplace_back(atom.value, id);
+        bounds.sorted = false;
+    } else {
+        auto &bounds = ranges.strings[static_cast<int>(op)];
+        bounds.entries.emplace_back(atom.value.asString(), id);
+        bounds.sorted = false;
+    }
+}
+
+void RuleIndex::collect(const RuleId id, std::vector<RuleId> &out) {
+    if (m_seen[id] == m_epoch) return;
+    m_seen[id] = m_epoch;
+    out.push_back(id);
+}
+
+template<typename T, typename Less>
+void RuleIndex::collectRange(Thresholds<T> &bounds, const RangeOp op, const T &val, Less less,
+                             std::vector<RuleId> &out) {
+    if (bounds.entries.empty()) return;
+
+    if (!bounds.sorted) {
+        std::ranges::sort(bounds.entries, less, &std::pair<T, RuleId>::first);
+        bounds.sorted = true;
+    }
+
+    // Entries are sorted by threshold, so every operator matches a prefix or a suffix
+    const auto begin = bounds.entries.begin(), end = bounds.entries.end();
+    const auto lower = std::ranges::lower_bound(bounds.entries, val, less, &std::pair<T, RuleId>::first);
+    const auto upper = std::ranges::upper_bound(bounds.entries, val, less, &std::pair<T, RuleId>::first);
+
+    auto first = begin, last = end;
+    switch (op) {
+        case RangeOp::LESS: first = upper; // val < t
+            break;
+        case RangeOp::LESS_OR_EQUALS: first = lower; // val <= t
+            break;
+        case RangeOp::GREATER: last = lower; // val > t
+            break;
+        case RangeOp::GREATER_OR_EQUALS: last = upper; // val >= t
+            break;
+    }
+
+    for (auto it = first; it != last; ++it) collect(it->second, out);
+}
@@ -1,2 +1,317 @@
 #include "../../includes/mbs/backend/runtime.h"
 
+#include <atomic>
+#include <cmath>
+#include <format>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+
+std::string valueTypeToString(const ValueType vt) {
+    switch (vt) {
+        case ValueType::NIL:
+            return "nil";
+        case ValueType::BOOL:
+            return "bool";
+        case ValueType::NUMBER:
+            return "number";
+        case ValueType::STRING:
+            return "string";
+        case ValueType::OBJECT:
+            return "object";
+        default:
+            return "any";
+    }
+}
+
+Shape::Shape(std::vector<Field> fields) : m_fields(std::move(fields)) {
+    // Id 0 is never handed out, caches use it as "empty"
+    static std::atomic<uint32_t> nextId{1};
+    m_id = nextId++;
+
+    for (int i = 0; i < static_cast<int>(m_fields.size()); ++i) {
+        m_index.emplace(m_fields[i].name, i);
+    }
+}
+
+int Shape::indexOf(const std::string &name) const {
+    const auto it = m_index.find(name);
+    return it == m_index.end() ? -1 : it->second;
+}
+
+RuntimeValue::RuntimeValue(const bool val) : value(val) {
+}
+
+RuntimeValue::RuntimeValue(const double val) : value(val) {
+}
+
+RuntimeValue::RuntimeValue(const int val) : value(static_cast<int64_t>(val)) {
+}
+
+RuntimeValue::RuntimeValue(const int64_t val) : value(val) {
+}
+
+RuntimeValue::RuntimeValue(std::string val) : value(StringValue{std::move(val)}) {
+}
+
+RuntimeValue::RuntimeValue(const char *val) : value(StringValue{val}) {
+}
+
+RuntimeValue::RuntimeValue(StringValue val) : value(std::move(val)) {
+}
+
+RuntimeValue RuntimeValue::interned(const std::string_view val) {
+    return StringInterner::global().intern(val);
+}
+
+RuntimeValue RuntimeValue::object(std::shared_ptr<const Shape> shape, std::vector<RuntimeValue> fields) {
+    if (fields.size() != shape->fields().size()) {
+        throw std::runtime_error(std::format("Object shape expects {} fields, got {}",
+                                             shape->fields().size(), fields.size()));
+    }
+
+    RuntimeValue val;
+    val.value = std::make_shared<const ObjectValue>(ObjectValue{std::move(shape), std::move(fields)});
+    return val;
+}
+
+bool RuntimeValue::isTruthy() const {
+    if (isNull()) return false;
+    if (isBool()) return asBool();
+    if (isNumber()) return asNumber() != 0.0;
+    if (isString()) return !asString().empty();
+    return true;
+}
+
+std::string RuntimeValue::typeName() const {
+    if (isNull()) return "nil";
+    if (isBool()) return "bool";
+    if (isNumber()) return "number";
+    if (isString()) return "string";
+    return "object";
+}
+
+RuntimeValue RuntimeValue::detached() const {
+    if (isString()) return asStringValue().detached();
+    return *this;
+}
+
+std::string RuntimeValue::toString() const {
+    if (isNull()) return "nil";
+    if (isBool()) return asBool() ? "true" : "false";
+    if (isInt()) return std::to_string(asInt());
+    if (isNumber()) {
+        std::stringstream oss;
+        oss << asNumber();
+        return oss.str();
+    }
+    if (isString()) return asString();
+
+    const auto &obj = asObject();
+    std::stringstream oss;
+    oss << "{ ";
+    for (std::size_t i = 0; i < obj.fields.size(); ++i) {
+        oss << (i ? ", " : "") << obj.shape->fields()[i].name << ": " << obj.fields[i].toString();
+    }
+    oss << " }";
+    return oss.str();
+}
+
+bool operator==(const RuntimeValue &lhs, const RuntimeValue &rhs) {
+    // `1 == 1.0`, integers and doubles are the same type to scripts
+    if (lhs.isNumber() && rhs.isNumber()) return compareNumbers(lhs, rhs) == std::partial_ordering::equivalent;
+    return lhs.value == rhs.value;
+}
+
+std::size_t RuntimeValueHash::operator()(const RuntimeValue &val) const noexcept {
+    if (val.isNull()) return 0;
+    if (val.isBool()) return std::hash<bool>{}(val.asBool()) + 1;
+    if (val.isInt()) return std::hash<int64_t>{}(val.asInt());
+    if (val.isNumber()) {
+        // Integral doubles hash like the equal integer, which also folds -0.0 into 0
+        const double num = val.asNumber();
+        if (num == std::trunc(num) && num >= -0x1p63 && num < 0x1p63)
+            return std::hash<int64_t>{}(static_cast<int64_t>(num));
+        return std::hash<double>{}(num);
+    }
+    if (val.isString()) return val.asStringValue().hash();
+    // Objects compare by identity
+    return std::hash<const ObjectValue *>{}(&val.asObject());
+}
+
+std::partial_ordering compareNumbers(const RuntimeValue &lhs, const RuntimeValue &rhs) {
+    if (lhs.isInt() && rhs.isInt()) return lhs.asInt() <=> rhs.asInt();
+    if (!lhs.isInt() && !rhs.isInt()) return lhs.asNumber() <=> rhs.asNumber();
+
+    // Mixed: compare the integer against the double's integral part, then its fraction
+    const bool flipped = rhs.isInt();
+    const int64_t i = flipped ? rhs.asInt() : lhs.asInt();
+    const double d = flipped ? lhs.asNumber() : rhs.asNumber();
+
+    std::partial_ordering order = std::partial_ordering::unordered;
+    if (std::isnan(d)) return order;
+
+    if (d >= 0x1p63) order = std::partial_ordering::less;
+    else if (d < -0x1p63) order = std::partial_ordering::greater;
+    else {
+        const double whole = std::trunc(d);
+        order = i <=> static_cast<int64_t>(whole);
+        if (order == std::partial_ordering::equivalent) order = 0.0 <=> d - whole;
+    }
+
+    return flipped ? 0 <=> order : order;
+}
+
+namespace {
+    bool checkedAdd(const int64_t a, const int64_t b, int64_t &out) {
+        return !__builtin_add_overflow(a, b, &out);
+    }
+
+    bool checkedSub(const int64_t a, const int64_t b, int64_t &out) {
+        return !__builtin_sub_overflow(a, b, &out);
+    }
+
+    bool checkedMul(const int64_t a, const int64_t b, int64_t &out) {
+        return !__builtin_mul_overflow(a, b, &out);
+    }
+
+    bool checkedPow(int64_t base, int64_t exp, int64_t &out) {
+        if (exp < 0) return false;
+        int64_t result = 1;
+        while (exp) {
+            if (exp & 1 && !checkedMul(result, base, result)) return false;
+            exp >>= 1;
+            if (exp && !checkedMul(base, base, base)) return false;
+        }
+        out = result;
+        return true;
+    }
+
+    RuntimeValue addNumbers(const RuntimeValue &a, const RuntimeValue &b) {
+        if (int64_t r; a.isInt() && b.isInt() && checkedAdd(a.asInt(), b.asInt(), r)) return r;
+        return a.asNumber() + b.asNumber();
+    }
+
+    RuntimeValue subNumbers(const RuntimeValue &a, const RuntimeValue &b) {
+        if (int64_t r; a.isInt() && b.isInt() && checkedSub(a.asInt(), b.asInt(), r)) return r;
+        return a.asNumber() - b.asNumber();
+    }
+
+    RuntimeValue mulNumbers(const RuntimeValue &a, const RuntimeValue &b) {
+        if (int64_t r; a.isInt() && b.isInt() && checkedMul(a.asInt(), b.asInt(), r)) return r;
+        return a.asNumber() * b.asNumber();
+    }
+
+    RuntimeValue divNumbers(const RuntimeValue &a, const RuntimeValue &b) {
+        // Exact quotients stay integers, `INT64_MIN / -1` overflows
+        if (a.isInt() && b.isInt() && b.asInt() != 0 && !(b.asInt() == -1 && a.asInt() == INT64_MIN)
+            && a.asInt() % b.asInt() == 0)
+            return a.asInt() / b.asInt();
+        return a.asNumber() / b.asNumber();
+    }
+
+    RuntimeValue modNumbers(const RuntimeValue &a, const RuntimeValue &b) {
+        // Truncated remainder, like `std::fmod`; `x % 0` stays NaN
+        if (a.isInt() && b.isInt() && b.asInt() != 0)
+            return b.asInt() == -1 ? int64_t{0} : a.asInt() % b.asInt();
+        return std::fmod(a.asNumber(), b.asNumber());
+    }
+
+    RuntimeValue powNumbers(const RuntimeValue &a, const RuntimeValue &b) {
+        if (int64_t r; a.isInt() && b.isInt() && checkedPow(a.asInt(), b.asInt(), r)) return r;
+        return std::pow(a.asNumber(), b.asNumber());
+    }
+
+    RuntimeValue negateNumber(const RuntimeValue &a) {
+        if (a.isInt() && a.asInt() != INT64_MIN) return -a.asInt();
+        return -a.asNumber();
+    }
+
+    [[noreturn]] void throwOperandError(const std::string &op, const RuntimeValue &lhs, const RuntimeValue &rhs) {
+        throw std::runtime_error(std::format("Unsupported operands for `{}`: {} and {}",
+                                             op, lhs.typeName(), rhs.typeName()));
+    }
+
+    template<typename Cmp>
+    RuntimeValue compare(const std::string &op, const RuntimeValue &lhs, const RuntimeValue &rhs, Cmp cmp) {
+        if (lhs.isNumber() && rhs.isNumber()) return cmp(compareNumbers(lhs, rhs));
+        if (lhs.isString() && rhs.isString()) return cmp(lhs.asString() <=> rhs.asString());
+        throwOperandError(op, lhs, rhs);
+    }
+}
+
+RuntimeValue applyUnaryOp(const std::string &op, const RuntimeValue &operand) {
+    if (op == "!") return !operand.isTruthy();
+
+    if (!operand.isNumber()) {
+        throw std::runtime_error(std::format("Unsupported operand for unary `{}`: {}", op, operand.typeName()));
+    }
+
+    if (op == "-") return negateNumber(operand);
+    if (op == "+") return operand;
+
+    throw std::runtime_error(std::format("Unknown unary operator `{}`", op));
+}
+
+RuntimeValue applyBinaryOp(const std::string &op, const RuntimeValue &lhs, const RuntimeValue &rhs) {
+    if (op == "==") return lhs == rhs;
+    if (op == "!=") return !(lhs == rhs);
+    if (op == "&&") return lhs.isTruthy() && rhs.isTruthy();
+    if (op == "||") return lhs.isTruthy() || rhs.isTruthy();
+
+    if (op == "<") return compare(op, lhs, rhs, [](const auto ord) { return ord < 0; });
+    if (op == "<=") return compare(op, lhs, rhs, [](const auto ord) { return ord <= 0; });
+    if (op == ">") return compare(op, lhs, rhs, [](const auto ord) { return ord > 0; });
+    if (op == ">=") return compare(op, lhs, rhs, [](const auto ord) { return ord >= 0; });
+
+    // String concatenation, any non-string operand is stringified
+    if (op == "+" && (lhs.isString() || rhs.isString())) return lhs.toString() + rhs.toString();
+
+    if (!lhs.isNumber() || !rhs.isNumber()) throwOperandError(op, lhs, rhs);
+
+    if (op == "+") return addNumbers(lhs, rhs);
+    if (op == "-") return subNumbers(lhs, rhs);
+    if (op == "*") return mulNumbers(lhs, rhs);
+    if (op == "/") return divNumbers(lhs, rhs);
+    if (op == "%") return modNumbers(lhs, rhs);
+    if (op == "**" || op == "^") return powNumbers(lhs, rhs);
+
+    throw std::runtime_error(std::format("Unknown binary operator `{}`", op));
+}
+
+BinaryOpFn specializedBinaryOp(const std::string &op, const ValueType lhs, const ValueType rhs) {
+    using VT = ValueType;
+    using Val = const RuntimeValue &;
+
+    if (lhs == VT::NUMBER && rhs == VT::NUMBER) {
+        if (op == "+") return addNumbers;
+        if (op == "-") return subNumbers;
+        if (op == "*") return mulNumbers;
+        if (op == "/") return divNumbers;
+        if (op == "%") return modNumbers;
+        if (op == "**" || op == "^") return powNumbers;
+        if (op == "==") return [](Val a, Val b) -> RuntimeValue { return compareNumbers(a, b) == 0; };
+        if (op == "!=") return [](Val a, Val b) -> RuntimeValue { return compareNumbers(a, b) != 0; };
+        if (op == "<") return [](Val a, Val b) -> RuntimeValue { return compareNumbers(a, b) < 0; };
+        if (op == "<=") return [](Val a, Val b) -> RuntimeValue { return compareNumbers(a, b) <= 0; };
+        if (op == ">") return [](Val a, Val b) -> RuntimeValue { return compareNumbers(a, b) > 0; };
+        if (op == ">=") return [](Val a, Val b) -> RuntimeValue { return compareNumbers(a, b) >= 0; };
+    }
+
+    if (lhs == VT::STRING && rhs == VT::STRING) {
+        if (op == "+") return [](Val a, Val b) -> RuntimeValue { return a.asString() + b.asString(); };
+        if (op == "==") return [](Val a, Val b) -> RuntimeValue { return a.asStringValue() == b.asStringValue(); };
+        if (op == "!=") return [](Val a, Val b) -> RuntimeValue { return !(a.asStringValue() == b.asStringValue()); };
+        if (op == "<") return [](Val a, Val b) -> RuntimeValue { return a.asString() < b.asString(); };
+        if (op == "<=") return [](Val a, Val b) -> RuntimeValue { return a.asString() <= b.asString(); };
+        if (op == ">") return [](Val a, Val b) -> RuntimeValue { return a.asString() > b.asString(); };
+        if (op == ">=") return [](Val a, Val b) -> RuntimeValue { return a.asString() >= b.asString(); };
+    }
+
+    if (lhs == VT::BOOL && rhs == VT::BOOL) {
+        if (op == "==") return [](Val a, Val b) -> RuntimeValue { return a.asBool() == b.asBool(); };
+        if (op == "!=") return [](Val a, Val b) -> RuntimeValue { return a.asBool() != b.asBool(); };
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,227 @@
+#include "../../includes/mbs/backend/specializer.h"
+
+#include <stdexcept>
+#include <vector>
+
+#include "../../includes/mbs/backend/profiler.h"
+#include "../../includes/mbs/frontend/ast.h"
+
+namespace {
+    // Either a folded value or the residual node still to be evaluated
+    struct Partial {
+        std::optional<RuntimeValue> value;
+        std::unique_ptr<AstNode> node;
+    };
+
+    std::unique_ptr<AstNode> toLiteral(const RuntimeValue &val) {
+        if (val.isBool()) return std::make_unique<BooleanLiteral>(val.asBool());
+        if (val.isInt()) return std::make_unique<NumberLiteral>(val.asInt());
+        if (val.isNumber()) return std::make_unique<NumberLiteral>(val.asNumber());
+        if (val.isString()) return std::make_unique<StringLiteral>(val.asString());
+        return std::make_unique<NullLiteral>();
+    }
+
+    // Objects have no literal form, so folded objects also carry the node producing them
+    std::unique_ptr<AstNode> materialize(Partial &&part) {
+        return part.value && !part.value->isObject() ? toLiteral(*part.value) : std::move(part.node);
+    }
+
+    bool isBoolValued(const AstNode &node) {
+        if (node.type == NodeType::BOOLEAN_LITERAL) return true;
+        if (node.type == NodeType::UNARY_EXPR) return static_cast<const UnaryExpr &>(node).op() == "!";
+        if (node.type == NodeType::MATCH_EXPR) return true;
+        if (node.type != NodeType::BINARY_EXPR) return false;
+
+        const auto &op = static_cast<const BinaryExpr &>(node).op();
+        return op == "==" || op == "!=" || op == "<" || op == "<=" || op == ">" || op == ">="
+               || op == "&&" || op == "||";
+    }
+
+    std::size_t countNodes(const AstNode &node) {
+        if (node.type == NodeType::UNARY_EXPR)
+            return 1 + countNodes(static_cast<const UnaryExpr &>(node).expr());
+        if (node.type == NodeType::BINARY_EXPR) {
+            const auto &expr = static_cast<const BinaryExpr &>(node);
+            return 1 + countNodes(expr.left()) + countNodes(expr.right());
+        }
+        if (node.type == NodeType::MEMBER_EXPR)
+            return 1 + countNodes(static_cast<const MemberExpr &>(node).object());
+        if (node.type == NodeType::MATCH_EXPR) {
+            const auto &match = static_cast<const MatchExpr &>(node);
+            return 1 + countNodes(match.subject()) + countNodes(match.pattern());
+        }
+        if (node.type == NodeType::CALL_EXPR) {
+            std::size_t count = 1;
+            for (const auto &arg: static_cast<const CallExpr &>(node).args()) count += countNodes(*arg);
+            return count;
+        }
+        return 1;
+    }
+
+    class Specializer {
+    public:
+        explicit Specializer(const Interpreter::Bindings &known) : m_known(known) {
+        }
+
+        Partial visit(const AstNode &node) {
+            switch (node.type) {
+                case NodeType::NUMBER_LITERAL:
+                    return {static_cast<const NumberLiteral &>(node).value(), nullptr};
+                case NodeType::STRING_LITERAL:
+                    return {static_cast<const StringLiteral &>(node).value(), nullptr};
+                case NodeType::BOOLEAN_LITERAL:
+                    return {static_cast<const BooleanLiteral &>(node).value(), nullptr};
+                case NodeType::NULL_LITERAL:
+                    return {RuntimeValue{}, nullptr};
+                case NodeType::IDENTIFIER:
+                    return visitIdent(static_cast<const IdentifierExpr &>(node));
+                case NodeType::UNARY_EXPR:
+                    return visitUnary(static_cast<const UnaryExpr &>(node));
+                case NodeType::BINARY_EXPR:
+                    return visitBinary(static_cast<const BinaryExpr &>(node));
+                case NodeType::MEMBER_EXPR:
+                    return visitMember(static_cast<const MemberExpr &>(node));
+                case NodeType::CALL_EXPR:
+                    return visitCall(static_cast<const CallExpr &>(node));
+                case NodeType::MATCH_EXPR:
+                    return visitMatch(static_cast<const MatchExpr &>(node));
+                default:
+                    throw std::runtime_error("Cannot specialize a nested program node");
+            }
+        }
+
+    private:
+        Partial visitIdent(const IdentifierExpr &ident) {
+            const auto it = m_known.find(ident.ident());
+            if (it != m_known.end() && !it->second.isObject()) return {it->second, nullptr};
+
+            return {
+                it == m_known.end() ? std::nullopt : std::optional{it->second},
+                std::make_unique<IdentifierExpr>(ident.ident())
+            };
+        }
+
+        Partial visitUnary(const UnaryExpr &unary) {
+            auto operand = visit(unary.expr());
+            if (operand.value) {
+                try {
+                    return {applyUnaryOp(unary.op(), *operand.value), nullptr};
+                } catch (const std::runtime_error &) {
+                    // Keep the failing expression, evaluation reports the error
+                }
+            }
+            return {std::nullopt, std::make_unique<UnaryExpr>(materialize(std::move(operand)), unary.op())};
+        }
+
+        Partial visitMember(const MemberExpr &member) {
+            auto object = visit(member.object());
+            std::optional<RuntimeValue> value;
+            if (object.value) {
+                try {
+                    value = member.access(*object.value);
+                    if (!value->isObject()) return {value, nullptr};
+                } catch (const std::runtime_error &) {
+                    // Keep the failing expression, evaluation reports the error
+                }
+            }
+            return {value, std::make_unique<MemberExpr>(materialize(std::move(object)), member.path())};
+        }
+
+        Partial visitCall(const CallExpr &call) {
+            const auto &builtin = builtins::at(call.builtin());
+
+            std::vector<Partial> args;
+            bool known = builtin.pure;
+            for (const auto &arg: call.args()) {
+                args.push_back(visit(*arg));
+                known = known && args.back().value;
+            }
+
+            if (known) {
+                std::vector<RuntimeValue> values;
+                for (const auto &arg: args) values.push_back(*arg.value);
+                try {
+                    return {builtin.fn(values), nullptr};
+                } catch (const std::runtime_error &) {
+                    // Keep the failing call, evaluation reports the error
+                }
+            }
+
+            std::vector<std::unique_ptr<AstNode> > residual;
+            for (auto &arg: args) residual.push_back(materialize(std::move(arg)));
+            return {std::nullopt, std::make_unique<CallExpr>(builtin.name, std::move(residual))};
+        }
+
+        Partial visitMatch(const MatchExpr &match) {
+            auto subject = visit(match.subject());
+            auto pattern = visit(match.pattern());
+            if (subject.value && pattern.value) {
+                try {
+                    return {match.match(*subject.value, *pattern.value), nullptr};
+                } catch (const std::runtime_error &) {
+                    // Keep the failing match, evaluation reports the error
+                }
+            }
+            return {
+                std::nullopt,
+                std::make_unique<MatchExpr>(materialize(std::move(subject)), materialize(std::move(pattern)))
+            };
+        }
+
+        Partial visitBinary(const BinaryExpr &expr) {
+            const auto &op = expr.op();
+            auto left = visit(expr.left());
+            auto right = visit(expr.right());
+
+            if (op == "&&" || op == "||") {
+                // `false && x` -> false, `true || x` -> true, and the same with sides swapped
+                const bool absorbing = op == "||";
+                if (left.value && left.value->isTruthy() == absorbing) return {absorbing, nullptr};
+                if (right.value && right.value->isTruthy() == absorbing) return {absorbing, nullptr};
+
+                // `true && x` -> x, only when x already yields a boolean
+                if (left.value && !right.value && isBoolValued(*right.node)) return right;
+                if (right.value && !left.value && isBoolValued(*left.node)) return left;
+            }
+
+            if (left.value && right.value) {
+                try {
+                    return {applyBinaryOp(op, *left.value, *right.value), nullptr};
+                } catch (const std::runtime_error &) {
+                    // Keep the failing expression, evaluation reports the error
+                }
+            }
+
+            return {
+                std::nullopt,
+                std::make_unique<BinaryExpr>(materialize(std::move(left)), op, materialize(std::move(right)))
+            };
+        }
+
+        const Interpreter::Bindings &m_known;
+    };
+}
+
+Specialization specialize(const AstRoot &program, const Interpreter::Bindings &known) {
+    MBS_PROFILE_PHASE(Profiler::Phase::COMPILE);
+    Specialization result;
+    result.residual = std::make_unique<AstRoot>();
+
+    Specializer specializer{known};
+    std::size_t before = 0, after = 0;
+
+    for (const auto &node: program.nodes()) {
+        before += countNodes(*node);
+
+        auto part = specializer.visit(*node);
+        // The program evaluates to its last expression
+        result.constant = part.value;
+
+        auto residual = materialize(std::move(part));
+        after += countNodes(*residual);
+        result.residual->addNode(std::move(residual));
+    }
+
+    result.removedNodes = before - after;
+    return result;
+}
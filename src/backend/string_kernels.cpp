@@ -0,0 +1,117 @@
+#include "../../includes/mbs/backend/string_kernels.h"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+    void foldScalar(const char *src, char *dst, const std::size_t n, const char first, const char flip) {
+        for (std::size_t i = 0; i < n; ++i) {
+            const char c = src[i];
+            dst[i] = c >= first && c <= first + 25 ? static_cast<char>(c ^ flip) : c;
+        }
+    }
+
+    std::size_t findScalar(const std::string_view haystack, const std::string_view needle, const std::size_t from) {
+        return haystack.find(needle, from);
+    }
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#if defined(__AVX2__)
+    using Vec = __m256i;
+    constexpr std::size_t WIDTH = 32;
+    Vec splat(const char c) { return _mm256_set1_epi8(c); }
+    Vec load(const char *p) { return _mm256_loadu_si256(reinterpret_cast<const Vec *>(p)); }
+    void store(char *p, const Vec v) { _mm256_storeu_si256(reinterpret_cast<Vec *>(p), v); }
+    uint32_t eqMask(const Vec a, const Vec b) {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+    }
+    Vec inRange(const Vec v, const Vec lo, const Vec hi) {
+        return _mm256_and_si256(_mm256_cmpgt_epi8(v, lo), _mm256_cmpgt_epi8(hi, v));
+    }
+    Vec flipIf(const Vec v, const Vec mask, const Vec flip) {
+        return _mm256_xor_si256(v, _mm256_and_si256(mask, flip));
+    }
+#else
+    using Vec = __m128i;
+    constexpr std::size_t WIDTH = 16;
+    Vec splat(const char c) { return _mm_set1_epi8(c); }
+    Vec load(const char *p) { return _mm_loadu_si128(reinterpret_cast<const Vec *>(p)); }
+    void store(char *p, const Vec v) { _mm_storeu_si128(reinterpret_cast<Vec *>(p), v); }
+    uint32_t eqMask(const Vec a, const Vec b) {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+    }
+    Vec inRange(const Vec v, const Vec lo, const Vec hi) {
+        return _mm_and_si128(_mm_cmpgt_epi8(v, lo), _mm_cmpgt_epi8(hi, v));
+    }
+    Vec flipIf(const Vec v, const Vec mask, const Vec flip) {
+        return _mm_xor_si128(v, _mm_and_si128(mask, flip));
+    }
+#endif
+
+    void fold(const char *src, char *dst, const std::size_t n, const char first, const char flip) {
+        // Signed compares, so bytes >= 0x80 never fall in the letter range
+        const Vec lo = splat(static_cast<char>(first - 1)), hi = splat(static_cast<char>(first + 26));
+        const Vec bit = splat(flip);
+
+        std::size_t i = 0;
+        for (; i + WIDTH <= n; i += WIDTH) {
+            const Vec v = load(src + i);
+            store(dst + i, flipIf(v, inRange(v, lo, hi), bit));
+        }
+        foldScalar(src + i, dst + i, n - i, first, flip);
+    }
+
+    std::size_t findVector(const std::string_view haystack, const std::string_view needle) {
+        // Compare the needle's first and last bytes against a whole block at once and
+        // only verify the full needle at offsets where both match.
+        const std::size_t k = needle.size(), n = haystack.size();
+        const Vec first = splat(needle.front()), last = splat(needle.back());
+        const char *hay = haystack.data();
+
+        std::size_t i = 0;
+        for (; i + k - 1 + WIDTH <= n; i += WIDTH) {
+            uint32_t mask = eqMask(load(hay + i), first) & eqMask(load(hay + i + k - 1), last);
+            while (mask) {
+                const std::size_t offset = i + std::countr_zero(mask);
+                if (std::memcmp(hay + offset + 1, needle.data() + 1, k > 2 ? k - 2 : 0) == 0) return offset;
+                mask &= mask - 1;
+            }
+        }
+        return findScalar(haystack, needle, i);
+    }
+#else
+    void fold(const char *src, char *dst, const std::size_t n, const char first, const char flip) {
+        foldScalar(src, dst, n, first, flip);
+    }
+
+    std::size_t findVector(const std::string_view haystack, const std::string_view needle) {
+        return findScalar(haystack, needle, 0);
+    }
+#endif
+}
+
+std::size_t kernels::find(const std::string_view haystack, const std::string_view needle) {
+    if (needle.empty()) return 0;
+    if (needle.size() > haystack.size()) return std::string_view::npos;
+    if (needle.size() == 1) {
+        // memchr is already vectorized
+        const void *hit = std::memchr(haystack.data(), needle.front(), haystack.size());
+        return hit ? static_cast<const char *>(hit) - haystack.data() : std::string_view::npos;
+    }
+    return findVector(haystack, needle);
+}
+
+void kernels::toLower(const char *src, char *dst, const std::size_t n) {
+    fold(src, dst, n, 'A', 0x20);
+}
+
+void kernels::toUpper(const char *src, char *dst, const std::size_t n) {
+    fold(src, dst, n, 'a', 0x20);
+}
@@ -0,0 +1,87 @@
+#include "../../includes/mbs/backend/strings.h"
+
+#include <functional>
+
+StringEntry::StringEntry(std::string text, const StringInterner *domain)
+    : text(std::move(text)),
+      hash(std::hash<std::string>{}(this->text)),
+      domain(domain) {
+}
+
+StringValue::StringValue(std::string text)
+    : m_owned(std::make_shared<const StringEntry>(std::move(text), nullptr)) {
+    m_entry = m_owned.get();
+}
+
+StringValue::StringValue(const StringEntry *entry) : m_entry(entry) {
+}
+
+StringValue StringValue::detached() const {
+    return isInterned() ? StringValue{str()} : *this;
+}
+
+StringInterner &StringInterner::global() {
+    static StringInterner interner;
+    return interner;
+}
+
+StringValue StringInterner::intern(const std::string_view text) {
+    std::lock_guard lock{m_mutex};
+    auto &entry = find(text);
+    entry.permanent = true;
+    return StringValue{&entry};
+}
+
+StringValue StringInterner::pin(const std::string_view text) {
+    std::lock_guard lock{m_mutex};
+    auto &entry = find(text);
+    ++entry.pins;
+    return StringValue{&entry};
+}
+
+void StringInterner::unpin(const StringValue &value) {
+    std::lock_guard lock{m_mutex};
+    const auto it = m_entries.find(value.str());
+    if (it == m_entries.end() || it->second.get() != value.m_entry) return;
+
+    auto &entry = *it->second;
+    if (entry.pins) --entry.pins;
+    if (entry.pins || entry.permanent) return;
+
+    m_payloadBytes -= footprint(entry);
+    m_entries.erase(it);
+}
+
+StringEntry &StringInterner::find(const std::string_view text) {
+    if (const auto it = m_entries.find(text); it != m_entries.end()) return *it->second;
+
+    auto entry = std::make_unique<StringEntry>(std::string{text}, this);
+    // Key on the entry's own text so the view stays valid
+    const std::string_view key = entry->text;
+    auto &ref = *entry;
+
+    m_payloadBytes += footprint(ref);
+    m_entries.emplace(key, std::move(entry));
+    return ref;
+}
+
+std::size_t StringInterner::footprint(const StringEntry &entry) {
+    // Short strings live inline in the `std::string`, only longer ones allocate
+    std::size_t bytes = sizeof(StringEntry);
+    if (entry.text.capacity() > std::string{}.capacity()) bytes += entry.text.capacity() + 1;
+    return bytes;
+}
+
+std::size_t StringInterner::size() const {
+    std::lock_guard lock{m_mutex};
+    return m_entries.size();
+}
+
+std::size_t StringInterner::memoryUsage() const {
+    std::lock_guard lock{m_mutex};
+
+    // Each map node holds the key view, the owning pointer, the cached hash and a next pointer
+    constexpr std::size_t nodeBytes = sizeof(std::string_view) + sizeof(std::unique_ptr<StringEntry>)
+                                        + sizeof(std::size_t) + sizeof(void *);
+    return m_payloadBytes + m_entries.size() * nodeBytes + m_entries.bucket_count() * sizeof(void *);
+}
@@ -0,0 +1,159 @@
+#include "../../includes/mbs/backend/type_checker.h"
+
+#include <format>
+#include <stdexcept>
+
+#include "../../includes/mbs/backend/profiler.h"
+#include "../../includes/mbs/frontend/ast.h"
+
+namespace {
+    bool isComparison(const std::string &op) {
+        return op == "<" || op == "<=" || op == ">" || op == ">=";
+    }
+
+    // A type that is `ANY` may still turn out to be `expected` at runtime
+    bool mayBe(const ValueType vt, const ValueType expected) {
+        return vt == ValueType::ANY || vt == expected;
+    }
+}
+
+TypeChecker::TypeChecker(Schema schema, Shapes shapes)
+    : m_schema(std::move(schema)),
+      m_shapes(std::move(shapes)) {
+}
+
+std::vector<std::string> TypeChecker::check(AstRoot &program) {
+    MBS_PROFILE_PHASE(Profiler::Phase::COMPILE);
+    m_errors.clear();
+    for (const auto &node: program.nodes()) {
+        infer(*node);
+    }
+    return std::move(m_errors);
+}
+
+ValueType TypeChecker::infer(AstNode &node) {
+    ValueType vt = ValueType::ANY;
+
+    switch (node.type) {
+        case NodeType::NUMBER_LITERAL:
+            vt = ValueType::NUMBER;
+            break;
+        case NodeType::STRING_LITERAL:
+            vt = ValueType::STRING;
+            break;
+        case NodeType::BOOLEAN_LITERAL:
+            vt = ValueType::BOOL;
+            break;
+        case NodeType::NULL_LITERAL:
+            vt = ValueType::NIL;
+            break;
+        case NodeType::IDENTIFIER: {
+            const auto &ident = static_cast<IdentifierExpr &>(node).ident();
+            if (m_shapes.contains(ident)) vt = ValueType::OBJECT;
+            else if (const auto it = m_schema.find(ident); it != m_schema.end()) vt = it->second;
+            break;
+        }
+        case NodeType::MEMBER_EXPR:
+            vt = inferMember(node);
+            break;
+        case NodeType::MATCH_EXPR: {
+            const auto &match = static_cast<MatchExpr &>(node);
+            const auto subject = infer(match.subject());
+            const auto pattern = infer(match.pattern());
+            if (!mayBe(subject, ValueType::STRING) || !mayBe(pattern, ValueType::STRING)) {
+                m_errors.push_back(std::format("Unsupported operands for `~=`: {} and {}",
+                                               valueTypeToString(subject), valueTypeToString(pattern)));
+                break;
+            }
+            vt = ValueType::BOOL;
+            break;
+        }
+        case NodeType::CALL_EXPR: {
+            const auto &call = static_cast<CallExpr &>(node);
+            for (const auto &arg: call.args()) infer(*arg);
+            vt = builtins::at(call.builtin()).returns;
+            break;
+        }
+        case NodeType::UNARY_EXPR:
+            vt = inferUnary(node);
+            break;
+        case NodeType::BINARY_EXPR:
+            vt = inferBinary(node);
+            break;
+        default:
+            break;
+    }
+
+    node.valueType = vt;
+    return vt;
+}
+
+ValueType TypeChecker::inferUnary(AstNode &node) {
+    auto &unary = static_cast<UnaryExpr &>(node);
+    const auto operand = infer(unary.expr());
+
+    if (unary.op() == "!") return ValueType::BOOL;
+
+    if (!mayBe(operand, ValueType::NUMBER)) {
+        m_errors.push_back(std::format("Unsupported operand for unary `{}`: {}",
+                                       unary.op(), valueTypeToString(operand)));
+        return ValueType::ANY;
+    }
+    return ValueType::NUMBER;
+}
+
+ValueType TypeChecker::inferBinary(AstNode &node) {
+    auto &expr = static_cast<BinaryExpr &>(node);
+    const auto &op = expr.op();
+    const auto lhs = infer(expr.left());
+    const auto rhs = infer(expr.right());
+
+    const auto mismatch = [&] {
+        m_errors.push_back(std::format("Unsupported operands for `{}`: {} and {}",
+                                       op, valueTypeToString(lhs), valueTypeToString(rhs)));
+        return ValueType::ANY;
+    };
+
+    ValueType result;
+    if (op == "&&" || op == "||" || op == "==" || op == "!=") {
+        result = ValueType::BOOL;
+    } else if (isComparison(op)) {
+        const bool numbers = mayBe(lhs, ValueType::NUMBER) && mayBe(rhs, ValueType::NUMBER);
+        const bool strings = mayBe(lhs, ValueType::STRING) && mayBe(rhs, ValueType::STRING);
+        if (!numbers && !strings) return mismatch();
+        result = ValueType::BOOL;
+    } else if (op == "+" && (lhs == ValueType::STRING || rhs == ValueType::STRING)) {
+        result = ValueType::STRING;
+    } else if (op == "+" && (lhs == ValueType::ANY || rhs == ValueType::ANY)) {
+        // Either a numeric add or a concatenation, depending on the runtime operand
+        result = ValueType::ANY;
+    } else {
+        if (!mayBe(lhs, ValueType::NUMBER) || !mayBe(rhs, ValueType::NUMBER)) return mismatch();
+        result = ValueType::NUMBER;
+    }
+
+    expr.setFastOp(specializedBinaryOp(op, lhs, rhs), lhs);
+    return result;
+}
+
+ValueType TypeChecker::inferMember(AstNode &node) {
+    const auto &member = static_cast<MemberExpr &>(node);
+    const auto object = infer(member.object());
+
+    if (object != ValueType::ANY && object != ValueType::OBJECT && object != ValueType::NIL) {
+        m_errors.push_back(std::format("Cannot access members on {}", valueTypeToString(object)));
+        return ValueType::ANY;
+    }
+
+    if (member.object().type != NodeType::IDENTIFIER) return ValueType::ANY;
+
+    const auto it = m_shapes.find(static_cast<IdentifierExpr &>(member.object()).ident());
+    if (it == m_shapes.end()) return ValueType::ANY;
+
+    try {
+        return member.bindShape(*it->second);
+    } catch (const std::runtime_error &e) {
+        m_errors.emplace_back(e.what());
+        return ValueType::ANY;
+    }
+}
@@ -1,4 +1,12 @@
 #include "../../includes/mbs/frontend/ast.h"
+#include "../../includes/mbs/frontend/serializer.h"
+#include "../../includes/mbs/backend/interpreter.h"
+#include "../../includes/mbs/backend/profiler.h"
+
+#include <array>
+#include <format>
+#include <sstream>
+#include <stdexcept>
 
 // ------------ AST NODE -------------------- //
 AstNode::AstNode(std::string name, const NodeType type)
@@ -8,6 +16,12 @@ AstNode::AstNode(std::string name, const NodeType type)
 
 AstNode::~AstNode() = default;
 
+std::string AstNode::toString() const {
+    std::ostringstream oss;
+    AstSerializer(oss, AstSerializer::Format::DEBUG).write(*this);
+    return oss.str();
+}
+
 // ------------ AST ROOT -------------------- //
 AstRoot::AstRoot() : AstNode("Program", NodeType::PROGRAM) {
 }
@@ -18,6 +32,29 @@ void AstRoot::addNode(std::unique_ptr<AstNode> node) {
     m_astNodes.push_back(std::move(node));
 }
 
+std::pmr::vector<std::unique_ptr<AstNode> > AstRoot::takeNodes() {
+    auto nodes = std::move(m_astNodes);
+    m_astNodes.clear();
+    return nodes;
+}
+
+void AstRoot::replaceNodes(const std::size_t first, const std::size_t last,
+                           std::pmr::vector<std::unique_ptr<AstNode> > nodes) {
+    const auto at = m_astNodes.erase(m_astNodes.begin() + static_cast<std::ptrdiff_t>(first),
+                                     m_astNodes.begin() + static_cast<std::ptrdiff_t>(last));
+    m_astNodes.insert(at, std::make_move_iterator(nodes.begin()), std::make_move_iterator(nodes.end()));
+}
+
+RuntimeValue AstRoot::eval(Interpreter &interp) {
+    return interp.evaluate(*this);
+}
+
+std::string AstRoot::toString() const {
+    std::ostringstream oss;
+    AstSerializer(oss, AstSerializer::Format::DEBUG).write(*this);
+    return oss.str();
+}
+
 // ------------ UNARY EXPR -------------------- //
 UnaryExpr::UnaryExpr(std::unique_ptr<AstNode> expr, std::string op)
     : AstNode("UnaryExpr", NodeType::UNARY_EXPR),
@@ -27,8 +64,10 @@ UnaryExpr::UnaryExpr(std::unique_ptr<AstNode> expr, std::string op)
 
 UnaryExpr::~UnaryExpr() = default;
 
-RuntimeValue UnaryExpr::eval() {
-    return {};
+RuntimeValue UnaryExpr::eval(Interpreter &interp) {
+    MBS_PROFILE_NODE(*this);
+    interp.step();
+    return applyUnaryOp(m_op, m_expr->eval(interp));
 }
 
 // ------------ BINARY EXPR -------------------- //
@@ -41,8 +80,183 @@ BinaryExpr::BinaryExpr(std::unique_ptr<AstNode> left, std::string op, std::uniqu
 
 BinaryExpr::~BinaryExpr() = default;
 
-RuntimeValue BinaryExpr::eval() {
-    return {};
+RuntimeValue BinaryExpr::eval(Interpreter &interp) {
+    MBS_PROFILE_NODE(*this);
+    interp.step();
+    if (m_fastOp) {
+        const auto lhs = m_left->eval(interp);
+        const auto rhs = m_right->eval(interp);
+        // Inferred types still miss nil along member paths and bindings disagreeing
+        // with the schema, those operands take the generic operator below
+        if (lhs.type() == m_fastOperands && rhs.type() == m_fastOperands) [[likely]] {
+            // Operand types are known here, so only string results need accounting
+            if (valueType != ValueType::STRING) return m_fastOp(lhs, rhs);
+
+            auto result = m_fastOp(lhs, rhs);
+            interp.charge(result);
+            return result;
+        }
+
+        auto result = applyBinaryOp(m_op, lhs, rhs);
+        interp.charge(result);
+        return result;
+    }
+
+    // Logical operators short-circuit, so the right side is only evaluated when needed
+    if (m_op == "&&") return m_left->eval(interp).isTruthy() && m_right->eval(interp).isTruthy();
+    if (m_op == "||") return m_left->eval(interp).isTruthy() || m_right->eval(interp).isTruthy();
+
+    const auto lhs = m_left->eval(interp);
+    auto result = applyBinaryOp(m_op, lhs, m_right->eval(interp));
+    interp.charge(result);
+    return result;
+}
+
+// ------------ MEMBER EXPR -------------------- //
+MemberExpr::MemberExpr(std::unique_ptr<AstNode> object, std::vector<std::string> path)
+    : AstNode("MemberExpr", NodeType::MEMBER_EXPR),
+      m_object(std::move(object)) {
+    m_path.reserve(path.size());
+    for (auto &field: path) {
+        m_path.emplace_back(std::move(field));
+    }
+}
+
+MemberExpr::~MemberExpr() = default;
+
+RuntimeValue MemberExpr::eval(Interpreter &interp) {
+    MBS_PROFILE_NODE(*this);
+    interp.step();
+    // Walk bound objects in place rather than copying the root value first
+    if (m_object->type == NodeType::IDENTIFIER && !interp.hasHost()) {
+        const auto *root = interp.find(static_cast<IdentifierExpr &>(*m_object).ident());
+        return root ? access(*root) : RuntimeValue{};
+    }
+    return access(m_object->eval(interp));
+}
+
+std::vector<std::string> MemberExpr::path() const {
+    std::vector<std::string> fields;
+    for (const auto &step: m_path) fields.push_back(step.field);
+    return fields;
+}
+
+RuntimeValue MemberExpr::access(const RuntimeValue &object) const {
+    // `object` keeps the whole chain alive, so walk it by pointer without copying
+    const RuntimeValue *cur = &object;
+
+    for (const auto &step: m_path) {
+        if (cur->isNull()) return {};
+        if (!cur->isObject()) {
+            throw std::runtime_error(std::format("Cannot access `{}` on {}", step.field, cur->typeName()));
+        }
+
+        const auto &obj = cur->asObject();
+        const auto cached = step.cache.load(std::memory_order_relaxed);
+        auto index = static_cast<uint32_t>(cached);
+        if (cached >> 32 != obj.shape->id()) {
+            // Cache miss, look the field up by name and re-prime for this shape
+            const int found = obj.shape->indexOf(step.field);
+            if (found < 0) return {};
+
+            index = static_cast<uint32_t>(found);
+            step.cache.store(PathStep::pack(obj.shape->id(), index), std::memory_order_relaxed);
+        }
+
+        cur = &obj.fields[index];
+    }
+
+    return *cur;
+}
+
+ValueType MemberExpr::bindShape(const Shape &shape) const {
+    const Shape *cur = &shape;
+    ValueType vt = ValueType::OBJECT;
+
+    for (const auto &step: m_path) {
+        // The rest of the path is resolved lazily once the layout is no longer known
+        if (!cur) return ValueType::ANY;
+
+        const int index = cur->indexOf(step.field);
+        if (index < 0) {
+            throw std::runtime_error(std::format("Unknown field `{}`", step.field));
+        }
+
+        step.cache.store(PathStep::pack(cur->id(), static_cast<uint32_t>(index)), std::memory_order_relaxed);
+
+        const auto &field = cur->fields()[index];
+        vt = field.type;
+        cur = field.shape.get();
+    }
+
+    return vt;
+}
+
+// ------------ CALL EXPR -------------------- //
+CallExpr::CallExpr(const std::string &fn, std::vector<std::unique_ptr<AstNode> > args)
+    : AstNode("CallExpr", NodeType::CALL_EXPR),
+      m_builtin(builtins::indexOf(fn)),
+      m_args(std::move(args)) {
+    if (m_builtin < 0) {
+        throw std::runtime_error(std::format("Unknown function `{}`", fn));
+    }
+
+    const auto &builtin = builtins::at(m_builtin);
+    if (m_args.size() < builtin.minArgs || m_args.size() > builtin.maxArgs) {
+        throw std::runtime_error(builtin.minArgs == builtin.maxArgs
+                                     ? std::format("`{}` takes {} argument(s), got {}",
+                                                   fn, builtin.minArgs, m_args.size())
+                                     : std::format("`{}` takes {} to {} arguments, got {}",
+                                                   fn, builtin.minArgs, builtin.maxArgs, m_args.size()));
+    }
+}
+
+CallExpr::~CallExpr() = default;
+
+RuntimeValue CallExpr::eval(Interpreter &interp) {
+    MBS_PROFILE_NODE(*this);
+    interp.step();
+    std::array<RuntimeValue, builtins::MAX_ARGS> args;
+    for (std::size_t i = 0; i < m_args.size(); ++i) {
+        args[i] = m_args[i]->eval(interp);
+    }
+    auto result = builtins::at(m_builtin).fn({args.data(), m_args.size()});
+    interp.charge(result);
+    return result;
+}
+
+// ------------ MATCH EXPR -------------------- //
+MatchExpr::MatchExpr(std::unique_ptr<AstNode> subject, std::unique_ptr<AstNode> pattern)
+    : AstNode("MatchExpr", NodeType::MATCH_EXPR),
+      m_subject(std::move(subject)),
+      m_pattern(std::move(pattern)) {
+    if (m_pattern->type == NodeType::STRING_LITERAL) {
+        m_compiled = PatternCache::global().get(static_cast<StringLiteral &>(*m_pattern).value());
+    }
+}
+
+MatchExpr::~MatchExpr() = default;
+
+RuntimeValue MatchExpr::eval(Interpreter &interp) {
+    MBS_PROFILE_NODE(*this);
+    interp.step();
+    const auto subject = m_subject->eval(interp);
+    if (m_compiled && subject.isString()) {
+        auto *scratch = interp.patternScratch();
+        return scratch ? m_compiled->matches(subject.asString(), *scratch) : m_compiled->matches(subject.asString());
+    }
+    return match(subject, m_pattern->eval(interp), interp.patternScratch());
+}
+
+RuntimeValue MatchExpr::match(const RuntimeValue &subject, const RuntimeValue &pattern,
+                              Pattern::Scratch *scratch) const {
+    if (!subject.isString() || !pattern.isString()) {
+        throw std::runtime_error(std::format("Unsupported operands for `~=`: {} and {}",
+                                             subject.typeName(), pattern.typeName()));
+    }
+
+    const auto compiled = m_compiled ? m_compiled : PatternCache::global().get(pattern.asString());
+    return scratch ? compiled->matches(subject.asString(), *scratch) : compiled->matches(subject.asString());
 }
 
 // ------------ IDENTIFIER LIT -------------------- //
@@ -53,8 +267,10 @@ IdentifierExpr::IdentifierExpr(std::string ident)
 
 IdentifierExpr::~IdentifierExpr() = default;
 
-RuntimeValue IdentifierExpr::eval() {
-    return {};
+RuntimeValue IdentifierExpr::eval(Interpreter &interp) {
+    MBS_PROFILE_NODE(*this);
+    if (m_slot >= 0 && interp.hasHost()) return interp.slot(m_slot);
+    return interp.lookup(m_ident);
 }
 
 // ------------ BOOLEAN LIT -------------------- //
@@ -65,8 +281,9 @@ BooleanLiteral::BooleanLiteral(const bool status)
 
 BooleanLiteral::~BooleanLiteral() = default;
 
-RuntimeValue BooleanLiteral::eval() {
-    return {};
+RuntimeValue BooleanLiteral::eval(Interpreter &) {
+    MBS_PROFILE_NODE(*this);
+    return m_bool;
 }
 
 // ------------ NUMBER LIT -------------------- //
@@ -75,10 +292,16 @@ NumberLiteral::NumberLiteral(const double val)
       m_val(val) {
 }
 
+NumberLiteral::NumberLiteral(const int64_t val)
+    : AstNode("NumberLiteral", NodeType::NUMBER_LITERAL),
+      m_val(val) {
+}
+
 NumberLiteral::~NumberLiteral() = default;
 
-RuntimeValue NumberLiteral::eval() {
-    return {};
+RuntimeValue NumberLiteral::eval(Interpreter &) {
+    MBS_PROFILE_NODE(*this);
+    return m_val;
 }
 
 // ------------ NULL LIT -------------------- //
@@ -88,18 +311,22 @@ NullLiteral::NullLiteral()
 
 NullLiteral::~NullLiteral() = default;
 
-RuntimeValue NullLiteral::eval() {
+RuntimeValue NullLiteral::eval(Interpreter &) {
+    MBS_PROFILE_NODE(*this);
     return {};
 }
 
 // ------------ STRING LIT -------------------- //
 StringLiteral::StringLiteral(std::string val)
-    : AstNode("StringLiteral", NodeType::NULL_LITERAL),
-      m_val(std::move(val)) {
+    : AstNode("StringLiteral", NodeType::STRING_LITERAL),
+      m_val(StringInterner::global().pin(val)) {
 }
 
-StringLiteral::~StringLiteral() = default;
+StringLiteral::~StringLiteral() {
+    StringInterner::global().unpin(m_val);
+}
 
-RuntimeValue StringLiteral::eval() {
-    return {};
+RuntimeValue StringLiteral::eval(Interpreter &) {
+    MBS_PROFILE_NODE(*this);
+    return m_val;
 }
@@ -0,0 +1,101 @@
+#include "../../includes/mbs/frontend/incremental.h"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+#include "../../includes/mbs/frontend/lexer.h"
+#include "../../includes/mbs/frontend/parser.h"
+
+mbs::IncrementalParser::IncrementalParser(std::string text) : m_text(std::move(text)) {
+    parseAll();
+}
+
+void mbs::IncrementalParser::edit(const std::size_t offset, const std::size_t removed, const std::string &inserted) {
+    if (offset > m_text.size() || removed > m_text.size() - offset) {
+        throw std::runtime_error(std::format("Edit of {} chars at {} is outside the {} char document",
+                                             removed, offset, m_text.size()));
+    }
+
+    const auto delta = static_cast<int>(inserted.size()) - static_cast<int>(removed);
+    const auto lineDelta = static_cast<int>(std::ranges::count(inserted, '\n'))
+                           - static_cast<int>(std::count(m_text.begin() + static_cast<std::ptrdiff_t>(offset),
+                                                         m_text.begin() + static_cast<std::ptrdiff_t>(offset + removed),
+                                                         '\n'));
+    m_text.replace(offset, removed, inserted);
+
+    if (m_stale || m_spans.empty()) {
+        parseAll();
+        return;
+    }
+
+    // The expression before the one touching the edit is included too, the edit
+    // may let it extend, e.g. by inserting an operator ahead of the next one
+    const auto editStart = static_cast<int>(offset), editEnd = static_cast<int>(offset + removed);
+    const auto touched = std::ranges::lower_bound(m_spans, editStart, {}, &Token::Position::end);
+    const auto first = static_cast<std::size_t>(std::max<std::ptrdiff_t>(touched - m_spans.begin() - 1, 0));
+    const auto after = static_cast<std::size_t>(
+        std::ranges::upper_bound(m_spans, editEnd, {}, &Token::Position::start) - m_spans.begin());
+
+    // Expressions past the edit are unchanged, only moved
+    for (auto i = after; i < m_spans.size(); ++i) {
+        m_spans[i].start += delta;
+        m_spans[i].end += delta;
+        m_spans[i].line += lineDelta;
+    }
+
+    // Everything ahead of the first expression is whitespace, re-lexed along with it
+    const auto start = first ? m_spans[first].start : 0, line = first ? m_spans[first].line : 1;
+    for (std::size_t last = after, grow = 1;; last = std::min(last + grow, m_spans.size()), grow *= 2) {
+        const auto atEnd = last == m_spans.size();
+        const auto stop = atEnd ? static_cast<int>(m_text.size()) : m_spans[last].start;
+        try {
+            if (reparse(first, last, start, stop, line)) return;
+        } catch (const std::exception &) {
+            // Errors are only final once the window covers the rest of the document
+            if (atEnd) {
+                m_stale = true;
+                throw;
+            }
+        }
+    }
+}
+
+void mbs::IncrementalParser::parseAll() {
+    m_stale = true;
+    Parser parser;
+    parser.parse(m_text);
+
+    m_root.replaceNodes(0, m_root.nodes().size(), parser.root().takeNodes());
+    m_spans = parser.spans();
+    m_reparsed = m_spans.size();
+    m_stale = false;
+}
+
+bool mbs::IncrementalParser::reparse(const std::size_t first, const std::size_t last, const int start,
+                                     const int stop, const int line) {
+    Lexer lexer;
+    lexer.lex(m_text, start, stop, line);
+    auto tokens = std::move(lexer.tokens);
+
+    // A token running past `stop` means the edit changed how the text after it lexes
+    if (tokens.back().pos.start != stop) return false;
+    if (static_cast<std::size_t>(stop) < m_text.size() && tokens.size() > 1) {
+        // Only the first expression can start with a unary `+`/`-`, which would now
+        // continue the expression before it as a binary operator
+        if (m_text[stop] == '+' || m_text[stop] == '-') return false;
+        // An identifier followed by `(` would turn into a call spanning the boundary
+        if (m_text[stop] == '(' && tokens[tokens.size() - 2].type == TokenType::TOK_IDENT) return false;
+    }
+
+    Parser parser;
+    parser.parse(std::move(tokens));
+
+    const auto &spans = parser.spans();
+    m_spans.erase(m_spans.begin() + static_cast<std::ptrdiff_t>(first),
+                  m_spans.begin() + static_cast<std::ptrdiff_t>(last));
+    m_spans.insert(m_spans.begin() + static_cast<std::ptrdiff_t>(first), spans.begin(), spans.end());
+    m_root.replaceNodes(first, last, parser.root().takeNodes());
+    m_reparsed = spans.size();
+    return true;
+}
@@ -4,13 +4,19 @@
 #include <iostream>
 
 const std::vector<mbs::Token> &mbs::Lexer::lex(const std::string &source) {
+    return lex(source, 0, static_cast<int>(source.size()), 1);
+}
+
+const std::vector<mbs::Token> &mbs::Lexer::lex(const std::string_view source, const int begin, const int stop,
+                                               const int line) {
     tokens.clear();
     m_src = source;
-    m_line = 1;
-    m_current = 0;
+    m_stop = stop;
+    m_line = line;
+    m_current = begin;
 
     // Iterate over all chars
-    while (!isEOF()) {
+    while (!isEOF() && m_current < m_stop) {
         if (std::isdigit(peek())) lexNumericals();
         else if (peek() == '"' || peek() == '\'') lexStrings();
         else if (std::isalpha(peek()) || peek() == '_') lexIdentifiers();
@@ -30,6 +36,9 @@ const std::vector<mbs::Token> &mbs::Lexer::lex(const std::string &source) {
         } else if (peek() == ':') {
             advance();
             makeToken(":", TokenType::TOK_COLON, m_current - 1);
+        } else if (peek() == ',') {
+            advance();
+            makeToken(",", TokenType::TOK_COMMA, m_current - 1);
         } else lexOperators();
     }
 
@@ -50,8 +59,9 @@ void mbs::Lexer::lexNumericals() {
     bool has_dot = false;
     while (std::isdigit(peek()) || peek() == '.') {
         if (peek() == '.') {
-            // We already have a float number, additional dots are for ops
-            if (has_dot) break;
+            // We already have a float number, additional dots are for ops,
+            // as is a dot not followed by a digit (`123.abs()`)
+            if (has_dot || !std::isdigit(peek(1))) break;
             has_dot = true;
         }
         num += advance();
@@ -64,24 +74,27 @@ void mbs::Lexer::lexStrings() {
     // Support both single quoted strings 'abc' and
     // double-quoted strings "abc"
     const int _start = m_current, _line = m_line;
-    std::string str;
 
     const char quote = advance(); // Consume opening quotation mark
+    const int _body = m_current;
     while (!isEOF() && peek() != quote) {
         // Check for strings spanning multiple lines
         if (peek() == '\n') {
             m_line++;
             m_index = 0;
         }
-        str += advance();
+        advance();
     }
 
+    // Copy the body out in one go once its extent is known
+    std::string str{m_src.substr(_body, m_current - _body)};
+
     expect(quote, std::format("Expected `{}` to terminate string starting at line {}, pos {}",
                               quote, _line, _start));
 
     tokens.emplace_back(
         Token{
-            .value = str,
+            .value = std::move(str),
             .pos{.start = _start, .end = m_current, .line = _line},
             .type = TokenType::TOK_STRING
         }
@@ -199,6 +212,21 @@ void mbs::Lexer::lexOperators() {
             // ! operator
             makeToken("!", TokenType::TOK_NOT, _start);
         }
+    } else if (op == '~') {
+        if (peek() == '=') {
+            // ~= operator
+            makeToken("~=", TokenType::TOK_MATCH, _start);
+            advance(); // Consume last '='
+        } else {
+            // Throw an error, we expected a '='
+            throw LexerException{
+                "Expected `=` after `~` token to form MATCH token!",
+                {
+                    .value = std::string{peek()},
+                    .pos = {m_current, m_current, m_line}
+                }
+            };
+        }
     } else if (op == '&') {
         if (peek() == '&') {
             // && operator
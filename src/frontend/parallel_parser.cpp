@@ -0,0 +1,128 @@
+#include "../../includes/mbs/frontend/parallel_parser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <exception>
+
+#include "../../includes/mbs/frontend/lexer.h"
+#include "../../includes/mbs/frontend/parser.h"
+
+namespace {
+    bool isQuote(const char c) {
+        return c == '"' || c == '\'';
+    }
+
+    // Last char of a literal, identifier or parenthesized expression
+    bool endsExpr(const char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || isQuote(c) || c == ')';
+    }
+
+    // First char of a token that no expression can be continued with. `(` would be
+    // a call after an identifier, and a leading `-`/`+` a binary operator.
+    bool startsExpr(const std::string &input, const std::size_t at, const char prev) {
+        const char c = input[at];
+        if (std::isalnum(static_cast<unsigned char>(c)) || c == '_' || isQuote(c)) return true;
+        if (c == '!') return at + 1 >= input.size() || input[at + 1] != '=';
+        if (c == '(') return prev == ')' || isQuote(prev);
+        return false;
+    }
+
+    struct Chunk {
+        std::pmr::vector<std::unique_ptr<AstNode> > nodes;
+        std::vector<mbs::Token::Position> spans;
+        std::exception_ptr error;
+    };
+}
+
+std::vector<mbs::Cut> mbs::findCuts(const std::string &input, const std::size_t chunks) {
+    std::vector<Cut> cuts;
+    if (chunks < 2) return cuts;
+
+    const auto step = input.size() / chunks;
+    auto target = step;
+    int depth = 0, line = 1;
+    char quote = 0, prev = 0;
+
+    for (std::size_t i = 0; i < input.size() && cuts.size() + 1 < chunks; ++i) {
+        const char c = input[i];
+        if (c == '\n') line++;
+
+        if (quote) {
+            if (c == quote) {
+                quote = 0;
+                prev = c;
+            }
+            continue;
+        }
+
+        if (isQuote(c)) quote = c;
+        else if (c == '(') depth++;
+        else if (c == ')') depth--;
+
+        if (c != '\n' || i < target || depth != 0 || !endsExpr(prev)) {
+            if (!std::isspace(static_cast<unsigned char>(c))) prev = c;
+            continue;
+        }
+
+        // Cut right before the next token, carrying the lines skipped to reach it
+        auto next = i + 1;
+        auto nextLine = line;
+        while (next < input.size() && std::isspace(static_cast<unsigned char>(input[next]))) {
+            if (input[next++] == '\n') nextLine++;
+        }
+        if (next < input.size() && startsExpr(input, next, prev)) {
+            cuts.push_back(Cut{.offset = static_cast<int>(next), .line = nextLine});
+            target = next + step;
+        }
+    }
+    return cuts;
+}
+
+mbs::ParallelParser::ParallelParser(const unsigned threads) : m_threads(std::max(threads, 1u)) {
+}
+
+void mbs::ParallelParser::parse(const std::string &input) {
+    m_root.replaceNodes(0, m_root.nodes().size(), {});
+    m_spans.clear();
+
+    // A few chunks per thread so that uneven chunks still balance out
+    const auto wanted = std::min<std::size_t>(m_threads * 4, input.size() / MIN_CHUNK_SIZE);
+    const auto cuts = m_threads > 1 ? findCuts(input, wanted) : std::vector<Cut>{};
+    m_chunks = cuts.size() + 1;
+
+    std::vector<Chunk> chunks(m_chunks);
+    std::atomic<std::size_t> nextChunk{0};
+    const auto work = [&] {
+        for (auto i = nextChunk++; i < chunks.size(); i = nextChunk++) {
+            const auto begin = i ? cuts[i - 1].offset : 0;
+            const auto end = i < cuts.size() ? cuts[i].offset : static_cast<int>(input.size());
+            try {
+                Lexer lexer;
+                lexer.lex(input, begin, end, i ? cuts[i - 1].line : 1);
+
+                Parser parser;
+                parser.parse(std::move(lexer.tokens));
+                chunks[i].nodes = parser.root().takeNodes();
+                chunks[i].spans = parser.spans();
+            } catch (...) {
+                chunks[i].error = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::jthread> workers;
+    for (unsigned t = 1; t < std::min<std::size_t>(m_threads, m_chunks); ++t) {
+        workers.emplace_back(work);
+    }
+    work();
+    workers.clear(); // Joins
+
+    for (const auto &chunk: chunks) {
+        if (chunk.error) std::rethrow_exception(chunk.error);
+    }
+    for (auto &chunk: chunks) {
+        for (auto &node: chunk.nodes) m_root.addNode(std::move(node));
+        m_spans.insert(m_spans.end(), chunk.spans.begin(), chunk.spans.end());
+    }
+}
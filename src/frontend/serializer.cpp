@@ -0,0 +1,286 @@
+#include "../../includes/mbs/frontend/serializer.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+#include "../../includes/mbs/backend/builtins.h"
+
+AstSerializer::AstSerializer(std::ostream &out, const Format format) : m_out(out), m_format(format) {
+}
+
+void AstSerializer::write(const AstRoot &root) {
+    const bool json = m_format == Format::JSON;
+    m_out << (json ? "[" : "[\n");
+    for (std::size_t i = 0; i < root.nodes().size(); ++i) {
+        if (json && i) m_out << ',';
+        write(*root.nodes()[i]);
+    }
+    m_out << (json ? "]" : "\n]\n");
+}
+
+void AstSerializer::write(const std::span<const mbs::Token> tokens) {
+    if (m_format == Format::DEBUG) {
+        for (const auto &token: tokens) m_out << token;
+        return;
+    }
+
+    m_out << '[';
+    for (std::size_t i = 0; i < tokens.size(); ++i) {
+        const auto &token = tokens[i];
+        m_out << (i ? "," : "") << "{\"type\":";
+        writeString(mbs::tokenTypeToString(token.type));
+        m_out << ",\"value\":";
+        writeString(token.value);
+        m_out << ",\"start\":" << token.pos.start << ",\"end\":" << token.pos.end;
+        m_out << ",\"line\":" << token.pos.line << '}';
+    }
+    m_out << ']';
+}
+
+void AstSerializer::write(const AstNode &node) {
+    m_pending.push_back(Item{.node = &node, .text = {}, .quoted = false});
+    drain();
+}
+
+void AstSerializer::drain() {
+    while (!m_pending.empty()) {
+        const auto item = m_pending.back();
+        m_pending.pop_back();
+
+        if (item.node) visit(*item.node);
+        else if (item.quoted) writeString(item.text);
+        else m_out << item.text;
+    }
+}
+
+void AstSerializer::visit(const AstNode &node) {
+    m_scheduled = m_pending.size();
+    switch (node.type) {
+        case NodeType::UNARY_EXPR:
+            visit(static_cast<const UnaryExpr &>(node));
+            break;
+        case NodeType::BINARY_EXPR:
+            visit(static_cast<const BinaryExpr &>(node));
+            break;
+        case NodeType::MEMBER_EXPR:
+            visit(static_cast<const MemberExpr &>(node));
+            break;
+        case NodeType::CALL_EXPR:
+            visit(static_cast<const CallExpr &>(node));
+            break;
+        case NodeType::MATCH_EXPR:
+            visit(static_cast<const MatchExpr &>(node));
+            break;
+        case NodeType::IDENTIFIER:
+            visit(static_cast<const IdentifierExpr &>(node));
+            break;
+        case NodeType::BOOLEAN_LITERAL:
+            visit(static_cast<const BooleanLiteral &>(node));
+            break;
+        case NodeType::NUMBER_LITERAL:
+            visit(static_cast<const NumberLiteral &>(node));
+            break;
+        case NodeType::NULL_LITERAL:
+            visit(static_cast<const NullLiteral &>(node));
+            break;
+        case NodeType::STRING_LITERAL:
+            visit(static_cast<const StringLiteral &>(node));
+            break;
+        default:
+            break;
+    }
+    // Scheduled in call order, but the top of the stack is written first
+    std::reverse(m_pending.begin() + static_cast<std::ptrdiff_t>(m_scheduled), m_pending.end());
+}
+
+// ------------ NODES -------------------- //
+void AstSerializer::visit(const UnaryExpr &node) {
+    writeType(node);
+    if (m_format == Format::JSON) {
+        m_out << ",\"op\":";
+        writeString(node.op());
+        m_out << ",\"expr\":";
+    } else {
+        m_out << ", op: " << node.op() << ", right: ";
+    }
+    then(node.expr());
+    then(m_format == Format::JSON ? "}" : " }");
+}
+
+void AstSerializer::visit(const BinaryExpr &node) {
+    if (m_format == Format::JSON) {
+        writeType(node);
+        m_out << ",\"op\":";
+        writeString(node.op());
+        m_out << ",\"left\":";
+        then(node.left());
+        then(",\"right\":");
+        then(node.right());
+        then("}");
+        return;
+    }
+
+    m_out << "\n{ \n\ttype: " << node.name << ", \n\tleft: ";
+    then(node.left());
+    then(", \n\top: ");
+    then(node.op());
+    then(", \n\tright: ");
+    then(node.right());
+    then(" \n}\n");
+}
+
+void AstSerializer::visit(const MemberExpr &node) {
+    writeType(node);
+    m_out << (m_format == Format::JSON ? ",\"object\":" : ", object: ");
+    then(node.object());
+
+    if (m_format == Format::JSON) {
+        then(",\"path\":[");
+        for (std::size_t i = 0; i < node.pathLength(); ++i) {
+            if (i) then(",");
+            thenString(node.field(i));
+        }
+        then("]}");
+        return;
+    }
+
+    then(", path: ");
+    for (std::size_t i = 0; i < node.pathLength(); ++i) {
+        if (i) then(".");
+        then(node.field(i));
+    }
+    then(" }");
+}
+
+void AstSerializer::visit(const CallExpr &node) {
+    const auto &fn = builtins::at(node.builtin()).name;
+    writeType(node);
+    if (m_format == Format::JSON) {
+        m_out << ",\"fn\":";
+        writeString(fn);
+        m_out << ",\"args\":[";
+    } else {
+        m_out << ", fn: " << fn << ", args: [";
+    }
+
+    const bool json = m_format == Format::JSON;
+    for (std::size_t i = 0; i < node.args().size(); ++i) {
+        if (json && i) then(",");
+        if (!json) then(i ? ", " : " ");
+        then(*node.args()[i]);
+    }
+    then(json ? "]}" : " ] }");
+}
+
+void AstSerializer::visit(const MatchExpr &node) {
+    writeType(node);
+    m_out << (m_format == Format::JSON ? ",\"subject\":" : ", subject: ");
+    then(node.subject());
+    then(m_format == Format::JSON ? ",\"pattern\":" : ", pattern: ");
+    then(node.pattern());
+    then(m_format == Format::JSON ? "}" : " }");
+}
+
+void AstSerializer::visit(const IdentifierExpr &node) {
+    writeType(node);
+    m_out << (m_format == Format::JSON ? ",\"name\":" : ", name: ");
+    writeString(node.ident());
+    m_out << (m_format == Format::JSON ? "}" : " }");
+}
+
+void AstSerializer::visit(const BooleanLiteral &node) {
+    writeType(node);
+    m_out << (m_format == Format::JSON ? ",\"value\":" : ", value: ") << (node.value() ? "true" : "false");
+    m_out << (m_format == Format::JSON ? "}" : " }");
+}
+
+void AstSerializer::visit(const NumberLiteral &node) {
+    const auto &val = node.value();
+    writeType(node);
+    if (m_format == Format::DEBUG) {
+        m_out << ", value: ";
+        if (val.isInt()) m_out << val.asInt();
+        else m_out << val.asNumber();
+        m_out << " }";
+        return;
+    }
+
+    // Shortest text that reads back as the same number; JSON has no infinities or NaN
+    m_out << ",\"value\":";
+    if (!val.isInt() && !std::isfinite(val.asNumber())) {
+        m_out << "null}";
+        return;
+    }
+    char buf[32];
+    const auto res = val.isInt()
+                         ? std::to_chars(buf, buf + sizeof(buf), val.asInt())
+                         : std::to_chars(buf, buf + sizeof(buf), val.asNumber());
+    m_out.write(buf, res.ptr - buf);
+    m_out << '}';
+}
+
+void AstSerializer::visit(const NullLiteral &node) {
+    writeType(node);
+    m_out << (m_format == Format::JSON ? "}" : " }");
+}
+
+void AstSerializer::visit(const StringLiteral &node) {
+    writeType(node);
+    m_out << (m_format == Format::JSON ? ",\"value\":" : ", value: ");
+    writeString(node.value());
+    m_out << (m_format == Format::JSON ? "}" : " }");
+}
+
+// ------------ OUTPUT -------------------- //
+void AstSerializer::then(const std::string_view text) {
+    m_pending.push_back(Item{.node = nullptr, .text = text, .quoted = false});
+}
+
+void AstSerializer::then(const AstNode &node) {
+    m_pending.push_back(Item{.node = &node, .text = {}, .quoted = false});
+}
+
+void AstSerializer::thenString(const std::string_view text) {
+    m_pending.push_back(Item{.node = nullptr, .text = text, .quoted = true});
+}
+
+void AstSerializer::writeString(const std::string_view text) {
+    if (m_format == Format::DEBUG) {
+        m_out << text;
+        return;
+    }
+
+    static constexpr char hex[] = "0123456789abcdef";
+    m_out << '"';
+    // Runs of plain chars are written at once, only escapes go out one by one
+    std::size_t plain = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        const auto c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        m_out.write(text.data() + plain, static_cast<std::streamsize>(i - plain));
+        plain = i + 1;
+        switch (c) {
+            case '"': m_out << "\\\"";
+                break;
+            case '\\': m_out << "\\\\";
+                break;
+            case '\n': m_out << "\\n";
+                break;
+            case '\t': m_out << "\\t";
+                break;
+            default: {
+                const char escape[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]};
+                m_out.write(escape, sizeof(escape));
+            }
+        }
+    }
+    m_out.write(text.data() + plain, static_cast<std::streamsize>(text.size() - plain));
+    m_out << '"';
+}
+
+void AstSerializer::writeType(const AstNode &node) {
+    if (m_format == Format::JSON) m_out << "{\"type\":\"" << node.name << '"';
+    else m_out << "{ type: " << node.name;
+}
@@ -87,6 +87,9 @@ std::string mbs::tokenTypeToString(const TokenType tt) {
         case TokenType::TOK_GREATER_OR_EQUALS:
             name = "TokenType::TOK_GREATER_OR_EQUALS";
             break;
+        case TokenType::TOK_MATCH:
+            name = "TokenType::TOK_MATCH";
+            break;
         case TokenType::TOK_AND:
             name = "TokenType::TOK_AND";
             break;
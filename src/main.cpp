@@ -1,26 +1,114 @@
+#include <charconv>
+#include <cstring>
+#include <format>
 #include <iostream>
 #include <vector>
 #include "../includes/mbs/frontend/lexer.h"
 #include "../includes/mbs/frontend/parser.h"
+#include "../includes/mbs/backend/interpreter.h"
+#include "../includes/mbs/backend/type_checker.h"
+#include "../includes/mbs/backend/profiler.h"
+#include "../includes/mbs/mbs.h"
+#include "../includes/mbs/server.h"
+
+// `:profile <expr> N`, evaluates `expr` N times and prints the hottest nodes
+void profile(const std::string &args) {
+    if constexpr (!Profiler::enabled) {
+        std::cout << "Profiling is compiled out, rebuild with -DMBS_PROFILE=ON" << std::endl;
+        return;
+    }
+
+    const auto split = args.find_last_of(' ');
+    std::size_t runs = 0;
+    if (split == std::string::npos
+        || std::from_chars(args.data() + split + 1, args.data() + args.size(), runs).ec != std::errc{}
+        || runs == 0) {
+        std::cout << "Usage: :profile <expr> N" << std::endl;
+        return;
+    }
+
+    Profiler profiler;
+    const Profiler::Session session(profiler);
+
+    mbs::Parser parser;
+    parser.parse(args.substr(0, split));
+    const auto errors = TypeChecker().check(parser.root());
+    for (const auto &err: errors) {
+        std::cout << "Type Error: " << err << std::endl;
+    }
+    if (!errors.empty()) return;
+
+    Interpreter interp;
+    RuntimeValue result;
+    for (std::size_t i = 0; i < runs; ++i) {
+        result = interp.evaluate(parser.root());
+    }
+    std::cout << "=> " << result.toString() << std::endl;
+
+    for (const auto phase: {Profiler::Phase::LEX, Profiler::Phase::PARSE,
+                            Profiler::Phase::COMPILE, Profiler::Phase::EVAL}) {
+        const auto &stats = profiler.phase(phase);
+        std::cout << std::format("{:>8}: {} ns over {} call(s)\n", phaseToString(phase), stats.nanos, stats.calls);
+    }
+
+    uint64_t total = 0;
+    for (const auto &stats: profiler.nodes()) total += stats.selfCycles;
+
+    std::cout << std::format("{:>6} {:>10} {:>12} {:>10}  {}\n", "self%", "count", "self/eval", "total/eval", "node");
+    for (const auto i: profiler.hottest(10)) {
+        const auto &stats = profiler.nodes()[i];
+        std::cout << std::format("{:>5.1f}% {:>10} {:>12.1f} {:>10.1f}  {}\n",
+                                 total ? 100.0 * stats.selfCycles / total : 0.0, stats.count,
+                                 static_cast<double>(stats.selfCycles) / stats.count,
+                                 static_cast<double>(stats.cycles) / stats.count, stats.label);
+    }
+}
+
+int main(const int argc, char **argv) {
+    // `mbs --serve [threads]`, answers framed requests on stdin/stdout, see `mbs::Server`
+    if (argc > 1 && std::string_view(argv[1]) == "--serve") {
+        unsigned threads = std::thread::hardware_concurrency();
+        if (argc > 2) std::from_chars(argv[2], argv[2] + std::strlen(argv[2]), threads);
+
+        std::ios::sync_with_stdio(false);
+        mbs::Server(threads).serve(std::cin, std::cout);
+        return 0;
+    }
 
-int main() {
     std::cout << "\nmb-script v0.0.1\n" << std::endl;
     std::string cmd;
 
     // Infinite cmd loop
     while (true) {
         std::cout << ">> ";
-        std::getline(std::cin, cmd);
+        if (!std::getline(std::cin, cmd)) break;
         std::cout << "CMD: '" << cmd << "'" << std::endl;
 
+        if (cmd.starts_with(":profile ")) {
+            try {
+                profile(cmd.substr(9));
+            } catch (const std::exception &e) {
+                std::cout << "Error: " << e.what() << std::endl;
+            }
+            continue;
+        }
+
         if (cmd == "exit") {
             std::cout << "Bye!" << std::endl;
             break;
         }
 
-        mbs::Parser parser;
-        parser.parse(cmd);
-        std::cout << parser.toString();
+        try {
+            auto program = mbs::Program::compile(cmd);
+            std::cout << program.toString();
+            std::cout << "=> " << program.evaluate().toString() << std::endl;
+        } catch (const mbs::CompileError &e) {
+            for (const auto &err: e.errors()) {
+                std::cout << "Type Error: " << err << std::endl;
+            }
+        } catch (const std::exception &e) {
+            std::cout << "Error: " << e.what() << std::endl;
+        }
         // for (auto token : tokens) {
         //     std::cout << token << std::endl;
         // }
@@ -0,0 +1,126 @@
+#include "../includes/mbs/mbs.h"
+
+#include <format>
+
+#include "../includes/mbs/backend/type_checker.h"
+#include "../includes/mbs/frontend/ast.h"
+#include "../includes/mbs/frontend/parser.h"
+
+namespace {
+    std::string joinErrors(const std::vector<std::string> &errors) {
+        std::string joined;
+        for (const auto &err: errors) {
+            joined += (joined.empty() ? "" : "\n") + err;
+        }
+        return joined;
+    }
+
+    // Binds every identifier to the slot of the field it names
+    void bindSlots(AstNode &node, const std::vector<mbs::HostField> &schema, std::vector<std::string> &errors) {
+        switch (node.type) {
+            case NodeType::IDENTIFIER: {
+                auto &ident = static_cast<IdentifierExpr &>(node);
+                for (std::size_t i = 0; i < schema.size(); ++i) {
+                    if (schema[i].name == ident.ident()) {
+                        ident.bindSlot(static_cast<int32_t>(i));
+                        return;
+                    }
+                }
+                errors.push_back(std::format("Unknown field `{}`", ident.ident()));
+                break;
+            }
+            case NodeType::UNARY_EXPR:
+                bindSlots(static_cast<UnaryExpr &>(node).expr(), schema, errors);
+                break;
+            case NodeType::BINARY_EXPR:
+                bindSlots(static_cast<BinaryExpr &>(node).left(), schema, errors);
+                bindSlots(static_cast<BinaryExpr &>(node).right(), schema, errors);
+                break;
+            case NodeType::MEMBER_EXPR:
+                bindSlots(static_cast<MemberExpr &>(node).object(), schema, errors);
+                break;
+            case NodeType::CALL_EXPR:
+                for (const auto &arg: static_cast<CallExpr &>(node).args()) bindSlots(*arg, schema, errors);
+                break;
+            case NodeType::MATCH_EXPR:
+                bindSlots(static_cast<MatchExpr &>(node).subject(), schema, errors);
+                bindSlots(static_cast<MatchExpr &>(node).pattern(), schema, errors);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+mbs::CompileError::CompileError(std::vector<std::string> errors)
+    : std::runtime_error(joinErrors(errors)),
+      m_errors(std::move(errors)) {
+}
+
+mbs::Program mbs::Program::compile(const std::string &source, const std::vector<HostField> &schema) {
+    Parser parser;
+    parser.parse(source);
+
+    auto root = std::make_unique<AstRoot>();
+    for (auto &node: parser.root().takeNodes()) root->addNode(std::move(node));
+
+    std::vector<std::string> errors;
+    TypeChecker::Schema types;
+    if (!schema.empty()) {
+        for (const auto &[name, type]: schema) types.emplace(name, type);
+        for (const auto &node: root->nodes()) bindSlots(*node, schema, errors);
+    }
+    if (!errors.empty()) throw CompileError(std::move(errors));
+
+    errors = TypeChecker(std::move(types)).check(*root);
+    if (!errors.empty()) throw CompileError(std::move(errors));
+
+    return Program(std::move(root));
+}
+
+mbs::Program::Program(std::unique_ptr<AstRoot> root) : m_root(std::move(root)) {
+}
+
+mbs::Program::Program(Program &&other) noexcept = default;
+
+mbs::Program &mbs::Program::operator=(Program &&other) noexcept = default;
+
+mbs::Program::~Program() = default;
+
+// Results returned by value may outlive the program, and with it its string literals
+RuntimeValue mbs::Program::evaluate(const Bindings &bindings) {
+    Interpreter interp(bindings);
+    return interp.evaluate(*m_root).detached();
+}
+
+BudgetedResult mbs::Program::evaluate(const Bindings &bindings, const EvalBudget &budget) {
+    Interpreter interp(bindings);
+    auto result = interp.evaluate(*m_root, budget);
+    result.value = result.value.detached();
+    return result;
+}
+
+RuntimeValue mbs::Program::evaluate(const void *host, const Interpreter::SlotReader *readers) {
+    Interpreter interp(host, readers);
+    return interp.evaluate(*m_root).detached();
+}
+
+std::span<const RuntimeValue> mbs::Program::evaluate(const Bindings &bindings, EvalScratch &scratch) {
+    Interpreter interp(bindings);
+    return interp.evaluate(*m_root, scratch);
+}
+
+std::span<const RuntimeValue> mbs::Program::evaluate(const void *host, const Interpreter::SlotReader *readers,
+                                                     EvalScratch &scratch) {
+    Interpreter interp(host, readers);
+    return interp.evaluate(*m_root, scratch);
+}
+
+BudgetedResult mbs::Program::evaluate(const Bindings &bindings, const EvalBudget &budget, EvalScratch &scratch) {
+    Interpreter interp(bindings);
+    return interp.evaluate(*m_root, budget, scratch);
+}
+
+std::string mbs::Program::toString() const {
+    return m_root->toString();
+}
@@ -0,0 +1,327 @@
+#include "../includes/mbs/server.h"
+
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    // Longest error message sent back, the rest is cut
+    constexpr std::size_t MAX_ERROR_LENGTH = 64 * 1024;
+
+    // Cursor over a request payload, throws on truncated or malformed input
+    class Reader {
+    public:
+        explicit Reader(const std::string_view data) : m_data(data) {
+        }
+
+        template<typename T>
+        T read() {
+            const auto bytes = take(sizeof(T));
+            std::make_unsigned_t<T> val = 0;
+            for (std::size_t i = 0; i < sizeof(T); ++i) {
+                val |= static_cast<std::make_unsigned_t<T> >(static_cast<unsigned char>(bytes[i])) << (8 * i);
+            }
+            return static_cast<T>(val);
+        }
+
+        std::string_view readString() {
+            return take(read<uint32_t>());
+        }
+
+        // Reads a count of entries taking at least `entrySize` bytes each, rejecting
+        // counts the rest of the payload can't hold before anything is allocated for them
+        std::size_t readCount(const std::size_t entrySize) {
+            const auto count = read<uint32_t>();
+            if (entrySize && count > remaining() / entrySize) {
+                throw std::runtime_error("Malformed request: count exceeds payload");
+            }
+            return count;
+        }
+
+        [[nodiscard]] std::size_t remaining() const {
+            return m_data.size() - m_pos;
+        }
+
+        RuntimeValue readValue() {
+            switch (static_cast<mbs::wire::Tag>(read<uint8_t>())) {
+                case mbs::wire::Tag::NIL: return {};
+                case mbs::wire::Tag::BOOL: return read<uint8_t>() != 0;
+                case mbs::wire::Tag::INT: return read<int64_t>();
+                case mbs::wire::Tag::DOUBLE: return std::bit_cast<double>(read<uint64_t>());
+                case mbs::wire::Tag::STRING: return std::string(readString());
+            }
+            throw std::runtime_error("Malformed request: unknown value tag");
+        }
+
+    private:
+        std::string_view take(const std::size_t size) {
+            if (size > remaining()) throw std::runtime_error("Malformed request: truncated");
+            const auto bytes = m_data.substr(m_pos, size);
+            m_pos += size;
+            return bytes;
+        }
+
+        std::string_view m_data;
+        std::size_t m_pos = 0;
+    };
+
+    template<typename T>
+    void write(std::string &out, const T val) {
+        auto bits = static_cast<std::make_unsigned_t<T> >(val);
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            out.push_back(static_cast<char>(bits & 0xff));
+            bits >>= 8;
+        }
+    }
+
+    void writeString(std::string &out, const std::string_view str) {
+        write(out, static_cast<uint32_t>(str.size()));
+        out.append(str);
+    }
+
+    void writeValue(std::string &out, const RuntimeValue &val) {
+        using mbs::wire::Tag;
+        if (val.isNull()) {
+            write(out, static_cast<uint8_t>(Tag::NIL));
+        } else if (val.isBool()) {
+            write(out, static_cast<uint8_t>(Tag::BOOL));
+            write(out, static_cast<uint8_t>(val.asBool()));
+        } else if (val.isInt()) {
+            write(out, static_cast<uint8_t>(Tag::INT));
+            write(out, val.asInt());
+        } else if (val.isNumber()) {
+            write(out, static_cast<uint8_t>(Tag::DOUBLE));
+            write(out, std::bit_cast<uint64_t>(val.asNumber()));
+        } else {
+            // Objects only reach clients in their printed form
+            write(out, static_cast<uint8_t>(Tag::STRING));
+            writeString(out, val.isString() ? val.asString() : val.toString());
+        }
+    }
+
+    void writeStatus(std::string &out, const mbs::wire::Status status) {
+        write(out, static_cast<uint8_t>(status));
+    }
+}
+
+// ------------ PROGRAM CACHE -------------------- //
+mbs::ProgramCache::ProgramCache(const std::size_t capacity) : m_capacity(std::max<std::size_t>(capacity, 1)) {
+}
+
+uint64_t mbs::ProgramCache::compile(const std::string &source) {
+    {
+        std::lock_guard lock{m_mutex};
+        if (const auto it = m_bySource.find(source); it != m_bySource.end()) {
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            return it->second->handle;
+        }
+    }
+
+    // Compile outside the lock, a concurrent miss on the same source just wins the race
+    auto program = std::make_shared<Program>(Program::compile(source));
+
+    std::lock_guard lock{m_mutex};
+    if (const auto it = m_bySource.find(source); it != m_bySource.end()) return it->second->handle;
+
+    m_lru.push_front(Entry{.handle = m_nextHandle++, .source = source, .program = std::move(program)});
+    m_bySource.emplace(m_lru.front().source, m_lru.begin());
+    m_byHandle.emplace(m_lru.front().handle, m_lru.begin());
+
+    if (m_lru.size() > m_capacity) evict(std::prev(m_lru.end()));
+    return m_lru.front().handle;
+}
+
+std::shared_ptr<mbs::Program> mbs::ProgramCache::find(const uint64_t handle) {
+    std::lock_guard lock{m_mutex};
+    const auto it = m_byHandle.find(handle);
+    if (it == m_byHandle.end()) return nullptr;
+
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->program;
+}
+
+void mbs::ProgramCache::release(const uint64_t handle) {
+    std::lock_guard lock{m_mutex};
+    if (const auto it = m_byHandle.find(handle); it != m_byHandle.end()) evict(it->second);
+}
+
+std::size_t mbs::ProgramCache::size() const {
+    std::lock_guard lock{m_mutex};
+    return m_lru.size();
+}
+
+void mbs::ProgramCache::evict(const std::list<Entry>::iterator it) {
+    // Evaluations still holding the program keep it alive until they finish
+    m_bySource.erase(it->source);
+    m_byHandle.erase(it->handle);
+    m_lru.erase(it);
+}
+
+// ------------ SERVER -------------------- //
+mbs::Server::Server(const unsigned threads, const std::size_t cacheCapacity)
+    : m_threads(std::max(threads, 1u)),
+      m_cache(cacheCapacity) {
+}
+
+void mbs::Server::serve(std::istream &in, std::ostream &out) {
+    // Reading would otherwise flush a tied `out` (as `std::cin` is to `std::cout`)
+    // behind the back of the workers writing to it
+    std::ostream *const tied = in.tie(nullptr);
+    m_closing = false;
+    std::vector<std::jthread> workers;
+    std::vector<EvalScratch> scratches(m_threads);
+    for (unsigned t = 0; t < m_threads; ++t) {
+        workers.emplace_back([this, &out, &scratch = scratches[t]] { work(out, scratch); });
+    }
+
+    // Bounded so that a client pipelining faster than we evaluate is throttled
+    const std::size_t maxQueued = m_threads * 64;
+    while (true) {
+        char header[4];
+        if (!in.read(header, sizeof(header))) break;
+        const auto size = Reader({header, sizeof(header)}).read<uint32_t>();
+        if (size > MAX_FRAME_SIZE) break;
+
+        std::string payload(size, '\0');
+        if (!in.read(payload.data(), size)) break;
+
+        std::unique_lock lock{m_mutex};
+        m_space.wait(lock, [&] { return m_queue.size() < maxQueued; });
+        m_queue.push_back(std::move(payload));
+        m_ready.notify_one();
+    }
+
+    {
+        std::lock_guard lock{m_mutex};
+        m_closing = true;
+    }
+    m_ready.notify_all();
+    workers.clear(); // Joins once the queue is drained
+    out.flush();
+    in.tie(tied);
+}
+
+void mbs::Server::work(std::ostream &out, EvalScratch &scratch) {
+    std::string frame;
+    while (true) {
+        std::string request;
+        {
+            std::unique_lock lock{m_mutex};
+            m_ready.wait(lock, [&] { return m_closing || !m_queue.empty(); });
+            if (m_queue.empty()) return;
+
+            request = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        m_space.notify_one();
+
+        // Never larger than `MAX_FRAME_SIZE`, so its size fits the length prefix
+        const auto response = handle(request, scratch);
+        frame.clear();
+        write(frame, static_cast<uint32_t>(response.size()));
+        frame += response;
+
+        std::lock_guard lock{m_outMutex};
+        out.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+        out.flush();
+    }
+}
+
+std::string mbs::Server::handle(const std::string_view request) {
+    EvalScratch scratch;
+    return handle(request, scratch);
+}
+
+std::string mbs::Server::handle(const std::string_view request, EvalScratch &scratch) {
+    std::string response;
+    Reader reader(request);
+    uint32_t id = 0;
+
+    try {
+        id = reader.read<uint32_t>();
+        write(response, id);
+
+        switch (static_cast<wire::Op>(reader.read<uint8_t>())) {
+            case wire::Op::COMPILE: {
+                const auto handle = m_cache.compile(std::string(reader.readString()));
+                writeStatus(response, wire::Status::OK);
+                write(response, handle);
+                break;
+            }
+            case wire::Op::EVALUATE: {
+                const auto handle = reader.read<uint64_t>();
+                const auto program = m_cache.find(handle);
+                if (!program) throw std::runtime_error(std::format("Unknown handle {}", handle));
+
+                // Names are bound once, each row only overwrites their values
+                Program::Bindings bindings;
+                std::vector<RuntimeValue *> slots(reader.readCount(sizeof(uint32_t)));
+                for (auto &slot: slots) slot = &bindings[std::string(reader.readString())];
+
+                // Each row holds at least a tag per name, and costs at least one step even
+                // when there are no names to read
+                const auto rows = static_cast<uint32_t>(reader.readCount(slots.size()));
+                if (rows > MAX_EVALUATE_STEPS) throw std::runtime_error("Malformed request: too many rows");
+                writeStatus(response, wire::Status::OK);
+                write(response, rows);
+
+                const auto deadline = std::chrono::steady_clock::now() + EVALUATE_TIMEOUT;
+                uint64_t steps = MAX_EVALUATE_STEPS;
+                for (uint32_t row = 0; row < rows; ++row) {
+                    // Checked between rows too, as rows shorter than `DEADLINE_CHECK_INTERVAL`
+                    // steps never read the clock
+                    if (steps == 0) throw BudgetExceeded(EvalBudget::Limit::STEPS);
+                    if (std::chrono::steady_clock::now() >= deadline) {
+                        throw BudgetExceeded(EvalBudget::Limit::DEADLINE);
+                    }
+
+                    for (auto *slot: slots) *slot = reader.readValue();
+                    const EvalBudget budget{.maxSteps = steps, .maxMemory = MAX_ROW_MEMORY, .deadline = deadline};
+                    BudgetedResult result;
+                    std::string error;
+                    try {
+                        result = program->evaluate(bindings, budget, scratch);
+                    } catch (const std::exception &e) {
+                        error = e.what();
+                    }
+
+                    // Steps and time are shared by every row, only memory is the row's own
+                    if (result.exceeded == EvalBudget::Limit::MEMORY) {
+                        error = BudgetExceeded(result.exceeded).what();
+                    } else if (result.exceeded != EvalBudget::Limit::NONE) {
+                        throw BudgetExceeded(result.exceeded);
+                    }
+                    steps -= std::clamp<uint64_t>(result.steps, 1, steps);
+
+                    if (error.empty()) {
+                        writeStatus(response, wire::Status::OK);
+                        writeValue(response, result.value);
+                    } else {
+                        writeStatus(response, wire::Status::ERROR);
+                        writeString(response, error);
+                    }
+                    if (response.size() > MAX_FRAME_SIZE) {
+                        throw std::runtime_error("Response exceeds the maximum frame size");
+                    }
+                }
+                break;
+            }
+            case wire::Op::RELEASE:
+                m_cache.release(reader.read<uint64_t>());
+                writeStatus(response, wire::Status::OK);
+                break;
+            default:
+                throw std::runtime_error("Malformed request: unknown op");
+        }
+    } catch (const std::exception &e) {
+        // Messages can quote the request, compile errors a whole source, so they are
+        // cut to keep the response within a frame
+        response.clear();
+        write(response, id);
+        writeStatus(response, wire::Status::ERROR);
+        writeString(response, std::string_view(e.what()).substr(0, MAX_ERROR_LENGTH));
+    }
+    return response;
+}
@@ -0,0 +1,164 @@
+// Evaluating into an `EvalScratch` must not allocate once the scratch is warm.
+// Every `operator new` is counted while the programs below, which together use
+// every node type, are evaluated through both `Program` and `TypedProgram`, and
+// their results are checked so that a program evaluating to nil cannot pass.
+//
+// Builtins and operators building new strings (`upper`, `lower`, `'a' + 'b'`)
+// allocate their result by design and are left out.
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../includes/mbs/mbs.h"
+
+namespace {
+    std::size_t allocations = 0;
+}
+
+void *operator new(const std::size_t size) {
+    ++allocations;
+    if (void *ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+struct Order {
+    int64_t qty;
+    double price;
+    StringValue sku;
+    bool rush;
+    RuntimeValue meta;
+};
+
+template<>
+struct mbs::Fields<Order> {
+    static constexpr auto list = std::tuple{
+        field("qty", &Order::qty),
+        field("price", &Order::price),
+        field("sku", &Order::sku),
+        field("rush", &Order::rush),
+        field("meta", &Order::meta),
+    };
+};
+
+namespace {
+    struct Case {
+        const char *what;
+        std::string source;
+        std::vector<std::string> results; // Of every top-level expression, as strings
+    };
+
+    const std::vector<Case> CASES = {
+        {"literals", "'ABC'\n42\n2.5\ntrue\nnil", {"ABC", "42", "2.5", "true", "nil"}},
+        {
+            "identifiers", "qty\nprice\nsku\nrush\nmeta",
+            {"5", "30.5", "ABC", "false", "{ tier: { level: 3 }, pattern: [A-C]+, missing: nil }"},
+        },
+        {"unary", "-qty * -price\n!rush", {"152.5", "true"}},
+        {
+            "binary", "qty * price > 100 && sku == 'ABC' || rush\nqty + 1 == 6\nprice / 2 != qty\nsku < 'B'",
+            {"true", "true", "true", "true"},
+        },
+        {"member", "meta.tier.level >= 2\nmeta.missing == nil\nmeta.pattern", {"true", "true", "[A-C]+"}},
+        {
+            "call", "len(sku) + abs(-3)\nfloor(price) + ceil(price)\nsku.startsWith('AB')\nsku.endsWith('C')\n"
+            "contains(sku, 'B')",
+            {"6", "61", "true", "true", "true"},
+        },
+        {"match, DFA", "sku ~= 'A.C'\nsku ~= '[A-C]+'\nsku ~= 'B.*'", {"true", "true", "false"}},
+        {
+            "match, NFA", "sku ~= '(a|b)*a(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)'",
+            {"false"},
+        },
+        {"match, dynamic pattern", "sku ~= meta.pattern", {"true"}},
+    };
+
+    Order makeOrder() {
+        const auto tier = std::make_shared<const Shape>(std::vector<Shape::Field>{
+            {"level", ValueType::NUMBER, nullptr},
+        });
+        const auto meta = std::make_shared<const Shape>(std::vector<Shape::Field>{
+            {"tier", ValueType::OBJECT, tier},
+            {"pattern", ValueType::STRING, nullptr},
+            {"missing", ValueType::ANY, nullptr},
+        });
+        return Order{
+            .qty = 5,
+            .price = 30.5,
+            .sku = StringValue(std::string("ABC")),
+            .rush = false,
+            .meta = RuntimeValue::object(meta, {RuntimeValue::object(tier, {int64_t{3}}), "[A-C]+", {}}),
+        };
+    }
+
+    // Allocations made by the last of a few evaluations, the first ones warming `scratch` up
+    template<typename Evaluate>
+    std::size_t allocationsOf(Evaluate &&evaluate) {
+        for (int i = 0; i < 3; ++i) evaluate();
+        allocations = 0;
+        evaluate();
+        return allocations;
+    }
+
+    // Whether `results` are `expected`, reporting the first difference otherwise
+    bool check(const Case &test, const char *how, const std::span<const RuntimeValue> results) {
+        for (std::size_t i = 0; i < test.results.size(); ++i) {
+            const auto actual = i < results.size() ? results[i].toString() : "no result";
+            if (actual != test.results[i]) {
+                std::cerr << test.what << ", " << how << ": expression " << i + 1 << " gave " << actual
+                        << " instead of " << test.results[i] << '\n';
+                return false;
+            }
+        }
+        if (results.size() == test.results.size()) return true;
+        std::cerr << test.what << ", " << how << ": " << results.size() << " results instead of "
+                << test.results.size() << '\n';
+        return false;
+    }
+}
+
+int main() {
+    const auto order = makeOrder();
+    const mbs::Program::Bindings bindings = {
+        {"qty", order.qty},
+        {"price", order.price},
+        {"sku", RuntimeValue::interned("ABC")},
+        {"rush", order.rush},
+        {"meta", order.meta},
+    };
+
+    int failures = 0;
+    for (const auto &test: CASES) {
+        auto typed = mbs::TypedProgram<Order>::compile(test.source);
+        auto program = mbs::Program::compile(test.source);
+        EvalScratch typedScratch, mapScratch;
+        std::span<const RuntimeValue> typedResults, mapResults;
+
+        const auto typedAllocations = allocationsOf([&] { typedResults = typed.evaluate(order, typedScratch); });
+        const auto mapAllocations = allocationsOf([&] { mapResults = program.evaluate(bindings, mapScratch); });
+
+        if (typedAllocations || mapAllocations) {
+            std::cerr << test.what << ": " << typedAllocations << " allocation(s) with a host object, "
+                    << mapAllocations << " with bindings\n";
+            ++failures;
+        }
+        if (!check(test, "host object", typedResults)) ++failures;
+        if (!check(test, "bindings", mapResults)) ++failures;
+    }
+
+    if (failures) return 1;
+    std::cout << "No allocations over " << CASES.size() << " cases\n";
+    return 0;
+}
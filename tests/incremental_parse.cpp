@@ -0,0 +1,222 @@
+// `IncrementalParser` and `ParallelParser` against a full parse with `Parser`.
+// Seeded random documents, with strings and parentheses spanning lines, go through
+// random edits; after each one the incremental AST and spans must be the ones of
+// a full reparse, serialized with `AstSerializer`, and an edit must fail exactly
+// when the full parse does. Every cut `findCuts` makes must fall on a top-level
+// expression boundary of the serial parse, and the parallel parse must match it.
+
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../includes/mbs/frontend/incremental.h"
+#include "../includes/mbs/frontend/parallel_parser.h"
+#include "../includes/mbs/frontend/parser.h"
+#include "../includes/mbs/frontend/serializer.h"
+
+namespace {
+    int failures = 0;
+
+    // The AST as JSON followed by the span of every top-level expression
+    std::string dump(const AstRoot &root, const std::vector<mbs::Token::Position> &spans) {
+        std::ostringstream out;
+        AstSerializer(out, AstSerializer::Format::JSON).write(root);
+        for (const auto &span: spans) out << '\n' << span.start << ' ' << span.end << ' ' << span.line;
+        return out.str();
+    }
+
+    // `dump` of a full parse of `text`, nothing when it doesn't parse
+    std::optional<std::string> parse(const std::string &text) {
+        try {
+            mbs::Parser parser;
+            parser.parse(text);
+            return dump(parser.root(), parser.spans());
+        } catch (const std::exception &) {
+            return std::nullopt;
+        }
+    }
+
+    // Random expressions over a few identifiers, with strings and parenthesized
+    // expressions sometimes spanning lines and binary expressions continued on the
+    // next line
+    class DocumentGenerator {
+    public:
+        explicit DocumentGenerator(std::mt19937 &rng) : m_rng(rng) {
+        }
+
+        std::string document(const std::size_t expressions) {
+            std::string text;
+            for (std::size_t i = 0; i < expressions; ++i) {
+                // A `(` starting the next line would call the identifier ending this one
+                const auto next = expr(3);
+                text += next.starts_with('(') ? "- " + next : next;
+                text += pick(4) == 0 ? "\n\n" : "\n";
+            }
+            return text;
+        }
+
+        std::size_t pick(const std::size_t n) {
+            return std::uniform_int_distribution<std::size_t>(0, n - 1)(m_rng);
+        }
+
+    private:
+        std::string expr(const int depth) {
+            static constexpr const char *OPERATORS[] = {" + ", " - ", " * ", " == ", " < ", " && ", " || "};
+            if (depth == 0) return primary();
+            switch (pick(6)) {
+                case 0: return primary();
+                case 1: return (pick(2) ? "- " : "!") + expr(depth - 1);
+                case 2:
+                    return "(" + expr(depth - 1) + (pick(3) ? "" : "\n") + OPERATORS[pick(7)] + expr(depth - 1) + ")";
+                case 3: return "len(" + expr(depth - 1) + ")";
+                case 4: return expr(depth - 1) + " ~= 'a.*'";
+                default: return expr(depth - 1) + (pick(4) ? "" : "\n") + OPERATORS[pick(7)] + expr(depth - 1);
+            }
+        }
+
+        std::string primary() {
+            static constexpr const char *PRIMARIES[] = {
+                "a", "b", "count", "user.role.level", "1", "42", "2.5", "'str'", "\"dq\"", "'two\nlines'",
+                "'(\n'", "')'", "true", "nil", "x.startsWith('a')",
+            };
+            return PRIMARIES[pick(std::size(PRIMARIES))];
+        }
+
+        std::mt19937 &m_rng;
+    };
+
+    // Applies random edits to a random document, comparing against full parses
+    void fuzzEdits(std::mt19937 &rng, const std::size_t edits) {
+        static constexpr const char *INSERTS[] = {
+            "", "a", "1", " ", "\n", "\n\n", "+", " - ", "(", ")", "'", "'x\ny'", "len(b)", "a.b", "(a\n+ b)",
+            "!", "==", ".", ",",
+        };
+
+        DocumentGenerator generator(rng);
+        std::string text = generator.document(20 + generator.pick(30));
+        mbs::IncrementalParser incremental(text);
+
+        for (std::size_t i = 0; i < edits && failures < 10; ++i) {
+            const auto offset = generator.pick(text.size() + 1);
+            const auto removed = std::min(generator.pick(5), text.size() - offset);
+            const std::string inserted = INSERTS[generator.pick(std::size(INSERTS))];
+            const auto before = text.substr(offset, removed);
+
+            text.replace(offset, removed, inserted);
+            auto expected = parse(text);
+
+            bool edited = true;
+            try {
+                incremental.edit(offset, removed, inserted);
+            } catch (const std::exception &) {
+                edited = false;
+            }
+
+            if (edited != expected.has_value()) {
+                std::cerr << "Edit at " << offset << ": " << (edited ? "parsed" : "failed") << " incrementally, "
+                        << (expected ? "parsed" : "failed") << " in full\n";
+                ++failures;
+            } else if (edited && dump(incremental.root(), incremental.spans()) != *expected) {
+                std::cerr << "Edit at " << offset << ": incremental AST differs from a full parse of\n"
+                        << text << '\n';
+                ++failures;
+            }
+            if (incremental.text() != text) {
+                std::cerr << "Edit at " << offset << ": incremental text differs\n";
+                ++failures;
+            }
+
+            // Undo edits breaking the document, which re-parses it all on the next edit
+            if (!expected) {
+                text.replace(offset, inserted.size(), before);
+                incremental.edit(offset, inserted.size(), before);
+                if (dump(incremental.root(), incremental.spans()) != parse(text)) {
+                    std::cerr << "Undoing a failed edit at " << offset << " left a different AST\n";
+                    ++failures;
+                }
+            }
+        }
+    }
+
+    // Whether `offset` is outside parentheses and strings, scanning `text` from the start
+    bool outside(const std::string &text, const int offset) {
+        int depth = 0;
+        char quote = 0;
+        for (int i = 0; i < offset; ++i) {
+            const char c = text[i];
+            if (quote) quote = c == quote ? 0 : quote;
+            else if (c == '\'' || c == '"') quote = c;
+            else if (c == '(') depth++;
+            else if (c == ')') depth--;
+        }
+        return depth == 0 && !quote;
+    }
+
+    // Every cut must be outside parentheses and strings and, when `text` parses, start
+    // a top-level expression of the serial parse on its line
+    void checkCuts(const std::string &text, const std::size_t chunks) {
+        std::vector<mbs::Token::Position> spans;
+        bool parses = true;
+        try {
+            mbs::Parser parser;
+            parser.parse(text);
+            spans = parser.spans();
+        } catch (const std::exception &) {
+            parses = false;
+        }
+
+        std::size_t expr = 0;
+        for (const auto &cut: mbs::findCuts(text, chunks)) {
+            while (expr < spans.size() && spans[expr].start < cut.offset) ++expr;
+            const bool boundary = expr < spans.size() && spans[expr].start == cut.offset
+                                  && spans[expr].line == cut.line;
+            if (!outside(text, cut.offset) || (parses && !boundary)) {
+                std::cerr << "Cut at offset " << cut.offset << ", line " << cut.line
+                        << " is not on a top-level expression boundary\n";
+                ++failures;
+                return;
+            }
+        }
+    }
+}
+
+int main() {
+    std::mt19937 rng(20261019);
+
+    for (int i = 0; i < 50 && failures < 10; ++i) fuzzEdits(rng, 120);
+
+    DocumentGenerator generator(rng);
+    for (int i = 0; i < 50 && failures < 10; ++i) {
+        checkCuts(generator.document(200), 2 + generator.pick(60));
+    }
+
+    // Lines that could each start an expression, but are inside parentheses or strings
+    std::string nested;
+    for (int i = 0; i < 500; ++i) {
+        const auto n = std::to_string(i);
+        nested += "(a" + n + "\nb)\n'c\n" + n + "'\n\"e\nf\"\nlen(g,\nh" + n + "\n)\n";
+    }
+    checkCuts(nested, 64);
+
+    // Large enough for the parallel parser to split into chunks
+    const auto large = generator.document(40000);
+    mbs::ParallelParser parallel(8);
+    parallel.parse(large);
+    checkCuts(large, 32);
+    if (parallel.chunks() < 2) {
+        std::cerr << "The parallel parser didn't split " << large.size() << " bytes\n";
+        ++failures;
+    }
+    if (dump(parallel.root(), parallel.spans()) != parse(large)) {
+        std::cerr << "Parallel parse differs from the serial one\n";
+        ++failures;
+    }
+
+    if (failures) return 1;
+    std::cout << "Incremental and parallel parses match full parses\n";
+    return 0;
+}
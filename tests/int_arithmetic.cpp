@@ -0,0 +1,137 @@
+// Integer arithmetic stays exact in int64 and only falls back to doubles when a
+// result overflows or is not integral. Mixed integer and double comparisons are
+// exact, and division by zero follows doubles rather than failing.
+
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "../includes/mbs/mbs.h"
+
+namespace {
+    int failures = 0;
+
+    const mbs::Program::Bindings BINDINGS = {
+        {"max", std::numeric_limits<int64_t>::max()},
+        {"min", std::numeric_limits<int64_t>::min()},
+        {"big", int64_t{9007199254740993}}, // 2^53 + 1, not representable as a double
+        {"bigDouble", 9007199254740992.0},
+        {"half", 0.5},
+    };
+
+    RuntimeValue evaluate(const std::string &source) {
+        return mbs::Program::compile(source).evaluate(BINDINGS);
+    }
+
+    void fail(const std::string &source, const std::string &expected, const RuntimeValue &actual) {
+        std::cerr << "`" << source << "`: expected " << expected << ", got " << actual.toString()
+                << (actual.isInt() ? " (int)" : actual.isNumber() ? " (double)" : "") << '\n';
+        ++failures;
+    }
+
+    // `source` must give exactly the integer `expected`
+    void expectInt(const std::string &source, const int64_t expected) {
+        try {
+            if (const auto actual = evaluate(source); !actual.isInt() || actual.asInt() != expected) {
+                fail(source, std::to_string(expected) + " (int)", actual);
+            }
+        } catch (const std::exception &e) {
+            fail(source, std::to_string(expected) + " (int)", std::string("error: ") + e.what());
+        }
+    }
+
+    // `source` must give the double `expected`, NaN included
+    void expectDouble(const std::string &source, const double expected) {
+        try {
+            const auto actual = evaluate(source);
+            const bool same = std::isnan(expected)
+                                  ? actual.isNumber() && std::isnan(actual.asNumber())
+                                  : actual.isNumber() && actual.asNumber() == expected;
+            if (actual.isInt() || !same) fail(source, std::to_string(expected) + " (double)", actual);
+        } catch (const std::exception &e) {
+            fail(source, std::to_string(expected) + " (double)", std::string("error: ") + e.what());
+        }
+    }
+
+    void expectBool(const std::string &source, const bool expected) {
+        try {
+            if (const auto actual = evaluate(source); !actual.isBool() || actual.asBool() != expected) {
+                fail(source, expected ? "true" : "false", actual);
+            }
+        } catch (const std::exception &e) {
+            fail(source, expected ? "true" : "false", std::string("error: ") + e.what());
+        }
+    }
+}
+
+int main() {
+    constexpr auto max = std::numeric_limits<int64_t>::max();
+    constexpr auto min = std::numeric_limits<int64_t>::min();
+    constexpr auto inf = std::numeric_limits<double>::infinity();
+    constexpr auto nan = std::numeric_limits<double>::quiet_NaN();
+
+    // Exact integer results
+    expectInt("max - 1 + 1", max);
+    expectInt("min + 1 - 1", min);
+    expectInt("3037000499 * 3037000499", 9223372030926249001);
+    expectInt("-max - 1", min);
+    expectInt("big + 1", 9007199254740994);
+    expectInt("6 / 3", 2);
+    expectInt("-7 / 7", -1);
+    expectInt("2 ** 62", int64_t{1} << 62);
+    expectInt("(-2) ** 63", min);
+
+    // Overflow promotes to doubles
+    expectDouble("max + 1", 9223372036854775808.0);
+    expectDouble("min - 1", -9223372036854775808.0);
+    expectDouble("3037000500 * 3037000500", 9223372037000250000.0);
+    expectDouble("max * -2", -18446744073709551614.0);
+    expectDouble("-min", 9223372036854775808.0);
+    expectDouble("2 ** 63", 9223372036854775808.0);
+    expectDouble("9223372036854775808", 9223372036854775808.0);
+
+    // Inexact quotients and negative powers are doubles
+    expectDouble("7 / 2", 3.5);
+    expectDouble("-7 / 2", -3.5);
+    expectDouble("2 ** -1", 0.5);
+    expectDouble("1 + half", 1.5);
+    expectDouble("big * 1.0", 9007199254740992.0);
+
+    // `INT64_MIN / -1` overflows, its remainder doesn't
+    expectDouble("min / -1", 9223372036854775808.0);
+    expectInt("min % -1", 0);
+    expectInt("max % -1", 0);
+
+    // Truncated remainder, the sign follows the dividend
+    expectInt("7 % 3", 1);
+    expectInt("-7 % 3", -1);
+    expectInt("7 % -3", 1);
+    expectInt("min % max", -1);
+    expectDouble("7.5 % 2", 1.5);
+
+    // Division by zero follows doubles
+    expectDouble("1 / 0", inf);
+    expectDouble("-1 / 0", -inf);
+    expectDouble("0 / 0", nan);
+    expectDouble("5 % 0", nan);
+    expectDouble("1.5 % 0", nan);
+
+    // Integers and doubles compare exactly, without rounding the integer
+    expectBool("big > bigDouble", true);
+    expectBool("big == bigDouble", false);
+    expectBool("big - 1 == bigDouble", true);
+    expectBool("max > 9223372036854775807.0", false);
+    expectBool("max < 9223372036854775808.0", true);
+    expectBool("min == -9223372036854775808.0", true);
+    expectBool("1 == 1.0", true);
+    expectBool("2 < 2.5", true);
+    expectBool("3 >= 2.5", true);
+    expectBool("0 / 0 == 0 / 0", false);
+
+    if (failures) return 1;
+    std::cout << "Integer arithmetic matches\n";
+    return 0;
+}
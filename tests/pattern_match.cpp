@@ -0,0 +1,207 @@
+// `Pattern` against `std::regex_match` on the same patterns and subjects. Fixed
+// cases cover anchors, classes, alternation, nested repetition and the literal
+// fast paths; seeded random patterns cover their combinations, and patterns over
+// the DFA state limit must give the same answers on the NFA fallback. Patterns
+// past the length and nesting limits must be rejected with a `std::runtime_error`.
+
+#include <exception>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../includes/mbs/backend/pattern.h"
+
+namespace {
+    int failures = 0;
+    std::size_t compared = 0;
+
+    // Subjects are drawn from these bytes, which `std::regex` and `Pattern` agree on.
+    // They stay short and random groups shallow, `std::regex` backtracks exponentially.
+    constexpr std::string_view ALPHABET = "abc1. ";
+
+    const char *kindName(const Pattern::Kind kind) {
+        switch (kind) {
+            case Pattern::Kind::EXACT: return "exact";
+            case Pattern::Kind::PREFIX: return "prefix";
+            case Pattern::Kind::SUFFIX: return "suffix";
+            case Pattern::Kind::SUBSTRING: return "substring";
+            case Pattern::Kind::DFA: return "DFA";
+            case Pattern::Kind::NFA: return "NFA";
+        }
+        return "?";
+    }
+
+    // Every subject must match `source` exactly when `std::regex_match` does
+    void compare(const std::string &source, const std::vector<std::string> &subjects) {
+        std::shared_ptr<const Pattern> pattern;
+        try {
+            pattern = Pattern::compile(source);
+        } catch (const std::exception &e) {
+            std::cerr << "`" << source << "`: " << e.what() << '\n';
+            ++failures;
+            return;
+        }
+
+        const std::regex expected(source, std::regex::ECMAScript);
+        Pattern::Scratch scratch;
+        for (const auto &subject: subjects) {
+            const bool want = std::regex_match(subject, expected);
+            const bool got = pattern->matches(subject);
+            if (got != want || pattern->matches(subject, scratch) != want) {
+                std::cerr << "`" << source << "` (" << kindName(pattern->kind()) << ") on \"" << subject
+                        << "\": " << got << " instead of " << want << '\n';
+                ++failures;
+                return;
+            }
+            ++compared;
+        }
+    }
+
+    void expectKind(const std::string &source, const Pattern::Kind kind) {
+        if (const auto actual = Pattern::compile(source)->kind(); actual != kind) {
+            std::cerr << "`" << source << "`: compiled to " << kindName(actual) << " instead of "
+                    << kindName(kind) << '\n';
+            ++failures;
+        }
+    }
+
+    void expectRejected(const std::string &what, const std::string &source) {
+        try {
+            (void) Pattern::compile(source);
+            std::cerr << what << ": compiled instead of being rejected\n";
+            ++failures;
+        } catch (const std::runtime_error &) {
+        }
+    }
+
+    // Every string over `ALPHABET` up to `length` bytes, plus seeded random longer ones
+    std::vector<std::string> makeSubjects(std::mt19937 &rng, const std::size_t length, const std::size_t longer) {
+        std::vector<std::string> subjects = {""};
+        for (std::size_t begin = 0, end = 1; subjects.back().size() < length; begin = end, end = subjects.size()) {
+            for (std::size_t i = begin; i < end; ++i) {
+                for (const char c: ALPHABET) subjects.push_back(subjects[i] + c);
+            }
+        }
+        std::uniform_int_distribution<std::size_t> size(length + 1, 8), byte(0, ALPHABET.size() - 1);
+        for (std::size_t i = 0; i < longer; ++i) {
+            std::string subject(size(rng), ' ');
+            for (auto &c: subject) c = ALPHABET[byte(rng)];
+            subjects.push_back(subject);
+        }
+        return subjects;
+    }
+
+    // Random pattern over the subject alphabet, with groups nested `depth` deep at most.
+    // Groups containing a quantifier are never quantified themselves: `std::regex`
+    // backtracks exponentially on those, they are in the fixed cases instead.
+    class PatternGenerator {
+    public:
+        explicit PatternGenerator(std::mt19937 &rng) : m_rng(rng) {
+        }
+
+        std::string pattern() {
+            std::string source = pick(4) == 0 ? "^" : "";
+            bool quantified = false;
+            source += alternation(2, quantified);
+            if (pick(4) == 0) source += '$';
+            return source;
+        }
+
+    private:
+        std::size_t pick(const std::size_t n) {
+            return std::uniform_int_distribution<std::size_t>(0, n - 1)(m_rng);
+        }
+
+        // `quantified` is set when the result contains a quantifier
+        std::string alternation(const int depth, bool &quantified) {
+            auto source = sequence(depth, quantified);
+            while (pick(3) == 0) source += '|' + sequence(depth, quantified);
+            return source;
+        }
+
+        std::string sequence(const int depth, bool &quantified) {
+            std::string source;
+            for (std::size_t i = 0, n = 1 + pick(3); i < n; ++i) source += repeated(depth, quantified);
+            return source;
+        }
+
+        std::string repeated(const int depth, bool &quantified) {
+            static constexpr const char *QUANTIFIERS[] = {"", "", "*", "+", "?"};
+            bool inner = false;
+            auto source = atom(depth, inner);
+            if (!inner) source += QUANTIFIERS[pick(std::size(QUANTIFIERS))];
+            quantified = quantified || inner || source.back() == '*' || source.back() == '+' || source.back() == '?';
+            return source;
+        }
+
+        std::string atom(const int depth, bool &quantified) {
+            static constexpr const char *ATOMS[] = {
+                "a", "b", "c", "1", ".", "\\.", " ", "[ab]", "[^a]", "[a-c]", "[^ .]", "\\d", "\\D", "\\w",
+                "\\W", "\\s", "\\S",
+            };
+            if (depth > 0 && pick(3) == 0) return '(' + alternation(depth - 1, quantified) + ')';
+            return ATOMS[pick(std::size(ATOMS))];
+        }
+
+        std::mt19937 &m_rng;
+    };
+}
+
+int main() {
+    std::mt19937 rng(20261019);
+    const auto subjects = makeSubjects(rng, 4, 200);
+
+    // Fixed cases, the literal fast paths included
+    const std::vector<std::string> fixed = {
+        "abc", "a.c", "abc.*", ".*abc", ".*a.c.*", ".*", "", "\\.", "a\\.b",
+        "^abc$", "^a.*", ".*c$", "^$", "^.*$", "a$", "^a",
+        "[abc]+", "[^abc]*", "[a-c1]*", "[^ ]+ [^ ]+", "[.]*", "[\\d ]+", "\\d+", "\\w\\W\\w", "\\s*\\S\\s*",
+        "a|b|c", "ab|a", "a|ab", "(a|b)(c|1)", "abc|.*1", "(|a)b",
+        "a*", "a+b+", "a?b?c?", "(ab)*", "(a*)*", "(a|b*)*c", "((a|b)*c)+", "(a(b(c)?)*)+", "((a*)+b?)*1",
+        "(a|b)*a(a|b)", ".*(a|1).(.|b)", "(.*1)(.*1)",
+    };
+    for (const auto &source: fixed) compare(source, subjects);
+
+    expectKind("abc", Pattern::Kind::EXACT);
+    expectKind("^abc.*", Pattern::Kind::PREFIX);
+    expectKind(".*abc$", Pattern::Kind::SUFFIX);
+    expectKind(".*abc.*", Pattern::Kind::SUBSTRING);
+    expectKind("a.c", Pattern::Kind::DFA);
+
+    // `(a|b)*a` followed by n more (a|b) needs 2^(n+1) DFA states, well over the limit
+    std::string nfa = "(a|b)*a";
+    for (int i = 0; i < 12; ++i) nfa += "(a|b)";
+    expectKind(nfa, Pattern::Kind::NFA);
+    {
+        std::vector<std::string> binary;
+        std::uniform_int_distribution<int> bit(0, 1), size(10, 24);
+        for (int i = 0; i < 2000; ++i) {
+            std::string subject(size(rng), 'a');
+            for (auto &c: subject) c = bit(rng) ? 'a' : 'b';
+            binary.push_back(subject);
+        }
+        compare(nfa, binary);
+        compare(nfa + "|c.*", subjects);
+    }
+
+    // Seeded random patterns
+    PatternGenerator generator(rng);
+    for (int i = 0; i < 1000 && failures < 10; ++i) compare(generator.pattern(), subjects);
+
+    // Limits
+    const auto nested = [](const int depth) { return std::string(depth, '(') + "a" + std::string(depth, ')'); };
+    compare(nested(Pattern::MAX_GROUP_DEPTH), {"a", "", "aa"});
+    expectRejected("groups nested one past the limit", nested(Pattern::MAX_GROUP_DEPTH + 1));
+    expectRejected("groups nested 100000 deep", nested(100000));
+    expectRejected("a pattern over the length limit", std::string(Pattern::MAX_LENGTH + 1, 'a'));
+    for (const auto *malformed: {"(", "(a", "a)", "[a", "*a", "a|*"}) {
+        expectRejected(std::string("`") + malformed + "`", malformed);
+    }
+
+    if (failures) return 1;
+    std::cout << "Patterns match std::regex over " << compared << " subjects\n";
+    return 0;
+}
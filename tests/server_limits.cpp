@@ -0,0 +1,153 @@
+// EVALUATE requests can't make the server do unbounded work or send an unbounded
+// response: rows share a step budget, each counting at least one step, a row
+// building too many string bytes fails on its own, and a response that would not
+// fit in a frame fails the request instead of being sent with a truncated length.
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../includes/mbs/server.h"
+
+using namespace mbs::wire;
+
+namespace {
+    int failures = 0;
+    mbs::Server server(1);
+
+    template<typename T>
+    void write(std::string &out, const T val) {
+        auto bits = static_cast<std::make_unsigned_t<T> >(val);
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            out.push_back(static_cast<char>(bits & 0xff));
+            bits >>= 8;
+        }
+    }
+
+    void writeString(std::string &out, const std::string_view str) {
+        write(out, static_cast<uint32_t>(str.size()));
+        out.append(str);
+    }
+
+    template<typename T>
+    T read(const std::string &in, std::size_t &pos) {
+        std::make_unsigned_t<T> val = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            val |= static_cast<std::make_unsigned_t<T> >(static_cast<unsigned char>(in[pos++])) << (8 * i);
+        }
+        return static_cast<T>(val);
+    }
+
+    std::string readString(const std::string &in, std::size_t &pos) {
+        const auto size = read<uint32_t>(in, pos);
+        pos += size;
+        return in.substr(pos - size, size);
+    }
+
+    uint64_t compile(const std::string &source) {
+        std::string request;
+        write(request, uint32_t{1});
+        write(request, static_cast<uint8_t>(Op::COMPILE));
+        writeString(request, source);
+
+        const auto response = server.handle(request);
+        std::size_t pos = sizeof(uint32_t);
+        if (read<uint8_t>(response, pos) != static_cast<uint8_t>(Status::OK)) {
+            throw std::runtime_error("`" + source + "` didn't compile: " + readString(response, pos));
+        }
+        return read<uint64_t>(response, pos);
+    }
+
+    // EVALUATE of `handle` binding `s` to each of `strings`, or no names with `rows` rows
+    std::string evaluate(const uint64_t handle, const std::vector<std::string> &strings, const uint32_t rows = 0) {
+        std::string request;
+        write(request, uint32_t{2});
+        write(request, static_cast<uint8_t>(Op::EVALUATE));
+        write(request, handle);
+        if (strings.empty()) {
+            write(request, uint32_t{0});
+            write(request, rows);
+        } else {
+            write(request, uint32_t{1});
+            writeString(request, "s");
+            write(request, static_cast<uint32_t>(strings.size()));
+            for (const auto &str: strings) {
+                write(request, static_cast<uint8_t>(Tag::STRING));
+                writeString(request, str);
+            }
+        }
+        return server.handle(request);
+    }
+
+    // "error: <message>" for a failed request, otherwise one line per row with its
+    // value, strings replaced by their length, or "error: <message>"
+    std::string decode(const std::string &response) {
+        std::size_t pos = sizeof(uint32_t);
+        if (read<uint8_t>(response, pos) != static_cast<uint8_t>(Status::OK)) {
+            return "error: " + readString(response, pos);
+        }
+
+        std::string rows;
+        for (auto count = read<uint32_t>(response, pos); count; --count) {
+            if (read<uint8_t>(response, pos) != static_cast<uint8_t>(Status::OK)) {
+                rows += "error: " + readString(response, pos) + '\n';
+                continue;
+            }
+            switch (static_cast<Tag>(read<uint8_t>(response, pos))) {
+                case Tag::INT: rows += std::to_string(read<int64_t>(response, pos)) + '\n';
+                    break;
+                case Tag::STRING: rows += std::to_string(readString(response, pos).size()) + " bytes\n";
+                    break;
+                default: rows += "unexpected value\n";
+            }
+        }
+        return rows;
+    }
+
+    void expect(const std::string &what, const std::string &response, const std::string &expected) {
+        if (response.size() > mbs::Server::MAX_FRAME_SIZE) {
+            std::cerr << what << ": " << response.size() << " bytes response\n";
+            ++failures;
+        } else if (const auto actual = decode(response); actual != expected) {
+            std::cerr << what << ": expected\n" << expected << "got\n" << actual.substr(0, 200) << '\n';
+            ++failures;
+        }
+    }
+}
+
+int main() {
+    const auto one = compile("1");
+    std::string ones = "1";
+    for (int i = 0; i < 999; ++i) ones += " + 1";
+    const auto sum = compile(ones);
+    const auto twice = compile("s + s");
+    const auto concat = compile("s + s + s + s + s + s + s + s + s");
+
+    // Rows without names still cost a step each
+    expect("3 rows without names", evaluate(one, {}, 3), "1\n1\n1\n");
+    expect("more rows than steps", evaluate(one, {}, mbs::Server::MAX_EVALUATE_STEPS + 1),
+           "error: Malformed request: too many rows");
+    expect("2^32 - 1 rows", evaluate(one, {}, UINT32_MAX), "error: Malformed request: too many rows");
+
+    // 999 steps a row, the request runs out of steps on the way
+    expect("one sum", evaluate(sum, {}, 1), "1000\n");
+    expect("too many sums", evaluate(sum, {}, mbs::Server::MAX_EVALUATE_STEPS / 999 + 1),
+           "error: Evaluation exceeded its steps budget");
+
+    // Only the row building too many bytes fails
+    const std::string mb(1024 * 1024, 'x');
+    expect("rows over the memory limit", evaluate(concat, {"ab", mb + mb + mb, "c"}),
+           "18 bytes\nerror: Evaluation exceeded its memory budget\n9 bytes\n");
+
+    // Each row answers close to 16 MiB, five of them are too large for a frame
+    const std::string large(mbs::Server::MAX_ROW_MEMORY / 2 - 1024, 'x');
+    const auto row = std::to_string(large.size() * 2) + " bytes\n";
+    expect("a response under the frame size", evaluate(twice, {large, large, large}), row + row + row);
+    expect("a response over the frame size", evaluate(twice, {large, large, large, large, large}),
+           "error: Response exceeds the maximum frame size");
+
+    if (failures) return 1;
+    std::cout << "EVALUATE requests stay within their budget and the frame size\n";
+    return 0;
+}
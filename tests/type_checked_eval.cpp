@@ -0,0 +1,143 @@
+// Operators specialized by the `TypeChecker` must behave like the generic ones when
+// an operand's runtime type disagrees with the inferred one: the same result, or
+// the same script error, never a `std::bad_variant_access`. Covers member paths
+// typed by shapes, and bindings disagreeing with the schema of a `Program`.
+
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../includes/mbs/mbs.h"
+#include "../includes/mbs/backend/interpreter.h"
+#include "../includes/mbs/backend/type_checker.h"
+#include "../includes/mbs/frontend/parser.h"
+
+namespace {
+    int failures = 0;
+
+    // Result of evaluating `source`, or the message of the error it threw
+    std::string outcome(const std::string &source, const Interpreter::Bindings &bindings,
+                        const TypeChecker::Shapes &shapes) {
+        try {
+            mbs::Parser parser;
+            parser.parse(source);
+            if (!shapes.empty()) {
+                if (const auto errors = TypeChecker({}, shapes).check(parser.root()); !errors.empty()) {
+                    return "type error: " + errors.front();
+                }
+            }
+            Interpreter interp(bindings);
+            return interp.evaluate(parser.root()).toString();
+        } catch (const std::runtime_error &e) {
+            return std::string("error: ") + e.what();
+        } catch (const std::exception &e) {
+            return std::string("unexpected exception: ") + e.what();
+        }
+    }
+
+    // Same as `outcome` for a `Program` compiled against `schema`
+    std::string programOutcome(const std::string &source, const Interpreter::Bindings &bindings,
+                               const std::vector<mbs::HostField> &schema) {
+        try {
+            return mbs::Program::compile(source, schema).evaluate(bindings).toString();
+        } catch (const std::runtime_error &e) {
+            return std::string("error: ") + e.what();
+        } catch (const std::exception &e) {
+            return std::string("unexpected exception: ") + e.what();
+        }
+    }
+
+    // `source` type checked against `shapes` must give `expected`, like it does unchecked
+    void expect(const std::string &source, const Interpreter::Bindings &bindings, const TypeChecker::Shapes &shapes,
+                const std::string &expected) {
+        const auto checked = outcome(source, bindings, shapes);
+        const auto unchecked = outcome(source, bindings, {});
+        if (checked != expected || unchecked != expected) {
+            std::cerr << "`" << source << "`: expected " << expected << ", got " << checked
+                    << " type checked and " << unchecked << " unchecked\n";
+            ++failures;
+        }
+    }
+
+    // `source` compiled against `schema` must give `expected`, like it does without one
+    void expect(const std::string &source, const Interpreter::Bindings &bindings,
+                const std::vector<mbs::HostField> &schema, const std::string &expected) {
+        const auto checked = programOutcome(source, bindings, schema);
+        const auto unchecked = programOutcome(source, bindings, {});
+        if (checked != expected || unchecked != expected) {
+            std::cerr << "`" << source << "`: expected " << expected << ", got " << checked
+                    << " with a schema and " << unchecked << " without\n";
+            ++failures;
+        }
+    }
+}
+
+int main() {
+    const auto role = std::make_shared<const Shape>(std::vector<Shape::Field>{
+        {"name", ValueType::STRING, nullptr}, {"level", ValueType::NUMBER, nullptr},
+    });
+    const auto user = std::make_shared<const Shape>(std::vector<Shape::Field>{
+        {"id", ValueType::STRING, nullptr}, {"role", ValueType::OBJECT, role},
+    });
+    const TypeChecker::Shapes shapes = {{"user", user}};
+
+    const Interpreter::Bindings admin = {
+        {"user", RuntimeValue::object(user, {"u1", RuntimeValue::object(role, {"admin", 3})})},
+    };
+    const Interpreter::Bindings noRole = {{"user", RuntimeValue::object(user, {"u2", {}})}};
+    const Interpreter::Bindings noName = {
+        {"user", RuntimeValue::object(user, {"u3", RuntimeValue::object(role, {{}, 1})})},
+    };
+    const Interpreter::Bindings wrongTypes = {
+        {"user", RuntimeValue::object(user, {"u4", RuntimeValue::object(role, {7, "high"})})},
+    };
+
+    expect("user.role.level >= 2", admin, shapes, "true");
+    expect("user.role.level + 1", admin, shapes, "4");
+    expect("user.role.name == 'admin'", admin, shapes, "true");
+
+    // A nil object along the path makes the leaf nil
+    expect("user.role.level >= 2", noRole, shapes, "error: Unsupported operands for `>=`: nil and number");
+    expect("user.role.level * 2", noRole, shapes, "error: Unsupported operands for `*`: nil and number");
+    expect("user.role.level == 3", noRole, shapes, "false");
+    expect("user.role.name + 'x'", noRole, shapes, "nilx");
+
+    // So does a nil field
+    expect("user.role.name < 'b'", noName, shapes, "error: Unsupported operands for `<`: nil and string");
+    expect("user.role.name != 'admin'", noName, shapes, "true");
+
+    // Fields holding values of another type than their shape declares
+    expect("user.role.level - 1", wrongTypes, shapes, "error: Unsupported operands for `-`: string and number");
+    expect("user.role.name == 'admin'", wrongTypes, shapes, "false");
+    expect("user.role.name + 'x'", wrongTypes, shapes, "7x");
+
+    // Bindings passed to a program compiled against a schema are not checked against it,
+    // operators specialized for the schema types must still handle them
+    const std::vector<mbs::HostField> schema = {
+        {"qty", ValueType::NUMBER}, {"sku", ValueType::STRING}, {"rush", ValueType::BOOL},
+    };
+    const Interpreter::Bindings order = {{"qty", 12}, {"sku", "AB-1"}, {"rush", true}};
+    const Interpreter::Bindings missing = {{"sku", "AB-1"}};
+    const Interpreter::Bindings mistyped = {{"qty", "12"}, {"sku", 7}, {"rush", 1}};
+
+    expect("qty * 2 > 10", order, schema, "true");
+    expect("sku + '!'", order, schema, "AB-1!");
+    expect("rush == true", order, schema, "true");
+
+    expect("qty * 2 > 10", missing, schema, "error: Unsupported operands for `*`: nil and number");
+    expect("qty == 12", missing, schema, "false");
+    expect("rush != false", missing, schema, "true");
+
+    expect("qty * 2 > 10", mistyped, schema, "error: Unsupported operands for `*`: string and number");
+    expect("qty + 1", mistyped, schema, "121");
+    expect("sku < 'B'", mistyped, schema, "error: Unsupported operands for `<`: number and string");
+    expect("sku == 'AB-1'", mistyped, schema, "false");
+    expect("rush == true", mistyped, schema, "false");
+
+    if (failures) return 1;
+    std::cout << "Type checked operators match the generic ones\n";
+    return 0;
+}